@@ -0,0 +1,246 @@
+//History.cpp : the standings after every match of a tournament, kept in a persistent treap
+//Author: Tigunova Anna
+
+#include "stdafx.h"
+#include "Tournament.h"
+using namespace std;
+
+
+//the priority of the team in the treap; any fixed mix of the number keeps the trees balanced on average
+static unsigned priorityOf(int team) {
+	unsigned p = (unsigned)team * 2654435761u;
+	return p ^ (p >> 15);
+}
+
+
+void StandingsHistory::clear(const TeamTable* table) {
+	teams = table;
+	records.clear();
+	roots.assign(1, -1);
+	history.clear();
+	folded.clear();
+}
+
+int StandingsHistory::current() const {
+	return (int)roots.size() - 1;
+}
+
+int StandingsHistory::size(int version) const {
+	int root = roots[version];
+	return root == -1 ? 0 : records[root].size;
+}
+
+//whether a is ranked above b: the same criteria as rankTeams
+bool StandingsHistory::before(const teamRecord& a, const teamRecord& b) const {
+	if (a.points != b.points)
+		return a.points > b.points;
+	if (a.wins != b.wins)
+		return a.wins > b.wins;
+	if (a.goalDiff != b.goalDiff)
+		return a.goalDiff > b.goalDiff;
+	if (a.scored != b.scored)
+		return a.scored > b.scored;
+	if (a.gameAm != b.gameAm)
+		return a.gameAm < b.gameAm;
+	int c = strcmp(a.gameAm > 0 ? folded[a.team].c_str() : "", b.gameAm > 0 ? folded[b.team].c_str() : "");
+	if (c != 0)
+		return c > 0;
+	return strcmp(teams->name(a.team).c_str(), teams->name(b.team).c_str()) > 0;
+}
+
+//a new record equal to r, which can be changed without changing any version
+int StandingsHistory::copy(int r) {
+	records.push_back(records[r]);
+	return (int)records.size() - 1;
+}
+
+void StandingsHistory::update(int r) {
+	teamRecord& n = records[r];
+	n.size = 1 + (n.left == -1 ? 0 : records[n.left].size) + (n.right == -1 ? 0 : records[n.right].size);
+}
+
+//splits the tree into the records ranked above key (returned) and the others, copying what changes
+//(the key is a copy: the records move when new ones are added)
+int StandingsHistory::split(int node, teamRecord key, int& rest) {
+	if (node == -1) {
+		rest = -1;
+		return -1;
+	}
+	node = copy(node);
+	if (before(records[node], key)) {
+		int right = split(records[node].right, key, rest);
+		records[node].right = right;
+		update(node);
+		return node;
+	}
+	int left;
+	int above = split(records[node].left, key, left);
+	records[node].left = left;
+	update(node);
+	rest = node;
+	return above;
+}
+
+int StandingsHistory::merge(int a, int b) {
+	if (a == -1)
+		return b;
+	if (b == -1)
+		return a;
+	if (priorityOf(records[a].team) > priorityOf(records[b].team)) {
+		a = copy(a);
+		int right = merge(records[a].right, b);
+		records[a].right = right;
+		update(a);
+		return a;
+	}
+	b = copy(b);
+	int left = merge(a, records[b].left);
+	records[b].left = left;
+	update(b);
+	return b;
+}
+
+int StandingsHistory::insert(int node, int r) {
+	int rest;
+	int above = split(node, records[r], rest);
+	return merge(merge(above, r), rest);
+}
+
+//takes out the record of the team of key, copying the path to it
+int StandingsHistory::erase(int node, teamRecord key) {
+	int left = records[node].left, right = records[node].right;
+	if (records[node].team == key.team)
+		return merge(left, right);
+	bool goLeft = before(key, records[node]);
+	if (goLeft)
+		left = erase(left, key);
+	else
+		right = erase(right, key);
+	node = copy(node);
+	records[node].left = left;
+	records[node].right = right;
+	update(node);
+	return node;
+}
+
+//a record with no results for the team, which is in the tables from now on
+teamRecord StandingsHistory::newRecord(int team) {
+	if ((int)history.size() <= team) {
+		history.resize(team+1);
+		folded.resize(team+1);
+	}
+	folded[team] = caseCheck(teams->name(team));
+
+	teamRecord r;
+	r.team = team;
+	r.points = r.wins = r.draws = r.loses = r.goalDiff = r.scored = r.missed = r.gameAm = 0;
+	r.left = r.right = -1;
+	r.size = 1;
+	return r;
+}
+
+void StandingsHistory::addTeam(int team) {
+	records.push_back(newRecord(team));
+	int id = (int)records.size() - 1;
+	history[team].push_back(make_pair(current(), id));
+	roots.back() = insert(roots.back(), id);
+}
+
+//one side of a match, as TeamTable::addMatch adds it
+static void addResult(teamRecord& r, int goalsFor, int goalsAgainst) {
+	r.scored += goalsFor;
+	r.missed += goalsAgainst;
+	r.goalDiff += goalsFor - goalsAgainst;
+	r.gameAm++;
+	if (goalsFor > goalsAgainst) {
+		r.wins++;
+		r.points += 3;
+	}
+	else if (goalsFor < goalsAgainst) {
+		r.loses++;
+	}
+	else {
+		r.draws++;
+		r.points++;
+	}
+}
+
+void StandingsHistory::addMatch(int team1, int goals1, int team2, int goals2) {
+	int root = roots.back();
+	int version = current() + 1;
+	int teamsOfMatch[2] = {team1, team2};
+	int goals[2][2] = {{goals1, goals2}, {goals2, goals1}};
+
+	//take the teams out, then put their new records in; a team that plays itself gets both sides in one record
+	int sides = (team2 != team1) ? 2 : 1;
+	teamRecord changed[2];
+	for (int i=0; i<sides; i++) {
+		int t = teamsOfMatch[i];
+		if (t < (int)history.size() && !history[t].empty()) {
+			changed[i] = records[history[t].back().second];
+			root = erase(root, changed[i]);
+		}
+		else {
+			//a team that wasn't listed joins the tables with its first match
+			changed[i] = newRecord(t);
+		}
+	}
+	addResult(changed[0], goals[0][0], goals[0][1]);
+	addResult(changed[sides-1], goals[1][0], goals[1][1]);
+	for (int i=0; i<sides; i++) {
+		changed[i].left = changed[i].right = -1;
+		changed[i].size = 1;
+		records.push_back(changed[i]);
+		int id = (int)records.size() - 1;
+		history[teamsOfMatch[i]].push_back(make_pair(version, id));
+		root = insert(root, id);
+	}
+	roots.push_back(root);
+}
+
+void StandingsHistory::top(int version, int n, vector<int>& result) const {
+	//in-order walk, stopped after n records
+	result.clear();
+	vector<int> path;
+	int node = roots[version];
+	while ((int)result.size() < n && (node != -1 || !path.empty())) {
+		while (node != -1) {
+			path.push_back(node);
+			node = records[node].left;
+		}
+		node = path.back();
+		path.pop_back();
+		result.push_back(node);
+		node = records[node].right;
+	}
+}
+
+int StandingsHistory::place(int version, int team) const {
+	if (team >= (int)history.size() || history[team].empty() || history[team][0].first > version)
+		return 0;
+	//the last record of the team up to the version
+	const vector<pair<int, int> >& h = history[team];
+	int lo = 0, hi = (int)h.size() - 1;
+	while (lo < hi) {
+		int mid = (lo + hi + 1) / 2;
+		if (h[mid].first <= version)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	const teamRecord& key = records[h[lo].second];
+
+	int above = 0;
+	int node = roots[version];
+	while (records[node].team != team) {
+		const teamRecord& n = records[node];
+		if (before(key, n)) {
+			node = n.left;
+		}
+		else {
+			above += 1 + (n.left == -1 ? 0 : records[n.left].size);
+			node = n.right;
+		}
+	}
+	return above + 1 + (records[node].left == -1 ? 0 : records[records[node].left].size);
+}
@@ -0,0 +1,159 @@
+//MatchLog.cpp : adding up very large logs of matches in parallel
+//Author: Tigunova Anna
+
+#include "stdafx.h"
+#include <thread>
+#include "Tournament.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+
+//the log is mapped into memory and cut into one piece per thread at the ends of lines; every thread adds up its
+//piece in a table of its own, so the threads share nothing while they work, and the tables are merged at the end.
+//A sum doesn't depend on the order of the matches and the ranking doesn't depend on the numbers of the teams,
+//so the result is exactly the one of reading the log line by line
+
+
+//the whole file mapped read only
+struct mappedLog {
+	const char* data;
+	size_t size;
+#ifdef _WIN32
+	HANDLE file, mapping;
+#endif
+};
+
+static bool mapLog(const char* name, mappedLog& m) {
+	m.data = 0;
+	m.size = 0;
+#ifdef _WIN32
+	m.file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (m.file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	GetFileSizeEx(m.file, &size);
+	m.size = (size_t)size.QuadPart;
+	if (m.size == 0) {
+		CloseHandle(m.file);
+		return true;
+	}
+	m.mapping = CreateFileMappingA(m.file, 0, PAGE_READONLY, 0, 0, 0);
+	if (m.mapping == 0) {
+		CloseHandle(m.file);
+		return false;
+	}
+	m.data = (const char*)MapViewOfFile(m.mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m.data == 0) {
+		CloseHandle(m.mapping);
+		CloseHandle(m.file);
+		return false;
+	}
+#else
+	int fd = open(name, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return false;
+	}
+	m.size = (size_t)st.st_size;
+	if (m.size == 0) {
+		close(fd);
+		return true;
+	}
+	void* p = mmap(0, m.size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); //the mapping stays valid
+	if (p == MAP_FAILED)
+		return false;
+	madvise(p, m.size, MADV_SEQUENTIAL);
+	m.data = (const char*)p;
+#endif
+	return true;
+}
+
+static void unmapLog(mappedLog& m) {
+	if (m.data == 0)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(m.data);
+	CloseHandle(m.mapping);
+	CloseHandle(m.file);
+#else
+	munmap((void*)m.data, m.size);
+#endif
+}
+
+
+//adds up the lines from begin to end, which are whole lines; empty lines are skipped and a '\r' before
+//the end of a line is not part of it
+static void addLines(const char* begin, const char* end, TeamTable* teams) {
+	while (begin < end) {
+		const char* eol = (const char*)memchr(begin, '\n', end - begin);
+		if (eol == 0)
+			eol = end;
+		size_t length = eol - begin;
+		if (length > 0 && begin[length-1] == '\r')
+			length--;
+		if (length > 0) {
+			slice team1, team2;
+			int sc1, sc2;
+			game(begin, length, team1, sc1, sc2, team2);
+			int t1 = teams->id(team1.text, team1.length);
+			int t2 = teams->id(team2.text, team2.length);
+			teams->addMatch(t1, sc1, t2, sc2);
+		}
+		begin = eol + 1;
+	}
+}
+
+
+bool readMatchLog(const char* name, int threads, TeamTable& teams) {
+	mappedLog m;
+	if (!mapLog(name, m))
+		return false;
+	teams.clear();
+	if (threads < 1)
+		threads = 1;
+	if (m.size < (size_t)threads * 4096) //not worth a thread
+		threads = 1;
+
+	//the pieces start at the beginning of a line, just after the '\n' at or behind size*i/threads
+	vector<const char*> cut(threads + 1);
+	const char* end = m.data + m.size;
+	cut[0] = m.data;
+	cut[threads] = end;
+	for (int i=1; i<threads; i++) {
+		const char* c = m.data + m.size / threads * i;
+		if (c < cut[i-1])
+			c = cut[i-1];
+		const char* eol = (const char*)memchr(c, '\n', end - c);
+		cut[i] = eol ? eol + 1 : end;
+	}
+
+	if (threads == 1) {
+		addLines(cut[0], cut[1], &teams);
+	}
+	else {
+		vector<TeamTable> partial(threads);
+		vector<thread> workers;
+		for (int i=0; i<threads; i++) {
+			partial[i].clear();
+			workers.push_back(thread(addLines, cut[i], cut[i+1], &partial[i]));
+		}
+		for (int i=0; i<threads; i++)
+			workers[i].join();
+		for (int i=0; i<threads; i++)
+			teams.merge(partial[i]);
+	}
+
+	unmapLog(m);
+	return true;
+}
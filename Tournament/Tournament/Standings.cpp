@@ -0,0 +1,144 @@
+//Standings.cpp : the standings of a tournament kept up to date match by match
+//Author: Tigunova Anna
+
+#include "stdafx.h"
+#include "Tournament.h"
+using namespace std;
+
+
+void Standings::clear(TeamTable* table) {
+	teams = table;
+	root = -1;
+}
+
+int Standings::size() const {
+	return root == -1 ? 0 : sizes[root];
+}
+
+//whether team a is ranked above team b: the same criteria as rankTeams
+bool Standings::before(int a, int b) const {
+	const TeamTable& t = *teams;
+	if (t.points[a] != t.points[b])
+		return t.points[a] > t.points[b];
+	if (t.wins[a] != t.wins[b])
+		return t.wins[a] > t.wins[b];
+	if (t.goalDiff[a] != t.goalDiff[b])
+		return t.goalDiff[a] > t.goalDiff[b];
+	if (t.scored[a] != t.scored[b])
+		return t.scored[a] > t.scored[b];
+	if (t.gameAm[a] != t.gameAm[b])
+		return t.gameAm[a] < t.gameAm[b];
+	int c = strcmp(folded[a].c_str(), folded[b].c_str());
+	if (c != 0)
+		return c > 0;
+	return strcmp(t.name(a).c_str(), t.name(b).c_str()) > 0;
+}
+
+void Standings::update(int node) {
+	sizes[node] = 1 + (left[node] == -1 ? 0 : sizes[left[node]]) + (right[node] == -1 ? 0 : sizes[right[node]]);
+}
+
+//splits the subtree into the teams ranked above the team (returned) and the others
+int Standings::split(int node, int team, int& rest) {
+	if (node == -1) {
+		rest = -1;
+		return -1;
+	}
+	if (before(node, team)) {
+		right[node] = split(right[node], team, rest);
+		update(node);
+		return node;
+	}
+	int above = split(left[node], team, left[node]);
+	update(node);
+	rest = node;
+	return above;
+}
+
+int Standings::merge(int a, int b) {
+	if (a == -1)
+		return b;
+	if (b == -1)
+		return a;
+	if (priority[a] > priority[b]) {
+		right[a] = merge(right[a], b);
+		update(a);
+		return a;
+	}
+	left[b] = merge(a, left[b]);
+	update(b);
+	return b;
+}
+
+void Standings::insert(int team) {
+	if ((int)left.size() <= team) {
+		left.resize(team+1);
+		right.resize(team+1);
+		sizes.resize(team+1);
+		priority.resize(team+1);
+		folded.resize(team+1);
+	}
+	left[team] = right[team] = -1;
+	sizes[team] = 1;
+	priority[team] = (unsigned)team * 2654435761u; //any fixed mix of the number keeps the tree balanced on average
+	priority[team] ^= priority[team] >> 15;
+	folded[team] = (teams->gameAm[team] > 0) ? caseCheck(teams->name(team)) : string();
+
+	int rest;
+	int above = split(root, team, rest);
+	root = merge(merge(above, team), rest);
+}
+
+//takes the team out of the subtree; its results have to be the ones it was put in with
+int Standings::erase(int node, int team) {
+	if (node == team)
+		return merge(left[node], right[node]);
+	if (before(team, node))
+		left[node] = erase(left[node], team);
+	else
+		right[node] = erase(right[node], team);
+	update(node);
+	return node;
+}
+
+void Standings::addMatch(int team1, int goals1, int team2, int goals2) {
+	root = erase(root, team1);
+	if (team2 != team1)
+		root = erase(root, team2);
+	teams->addMatch(team1, goals1, team2, goals2);
+	insert(team1);
+	if (team2 != team1)
+		insert(team2);
+}
+
+int Standings::place(int team) const {
+	int above = 0;
+	int node = root;
+	while (node != team) {
+		if (before(team, node)) {
+			node = left[node];
+		}
+		else {
+			above += 1 + (left[node] == -1 ? 0 : sizes[left[node]]);
+			node = right[node];
+		}
+	}
+	return above + 1 + (left[team] == -1 ? 0 : sizes[left[team]]);
+}
+
+void Standings::top(int n, vector<int>& order) const {
+	//in-order walk, stopped after n teams
+	order.clear();
+	vector<int> path;
+	int node = root;
+	while ((int)order.size() < n && (node != -1 || !path.empty())) {
+		while (node != -1) {
+			path.push_back(node);
+			node = left[node];
+		}
+		node = path.back();
+		path.pop_back();
+		order.push_back(node);
+		node = right[node];
+	}
+}
@@ -4,103 +4,49 @@
 #include "stdafx.h"
 #include <cstdio>
 #include <fstream>
-#include <map>
-#include <string>
+#include <iostream>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include "Tournament.h"
 using namespace std;
 
 
-//this class will provide properties of the team
-class Team
-{
-	private:
-		string teamName;
-		int teamPoints;
-		int teamWins;
-		int teamDraws;
-		int teamLoses;
-		int teamGoalDiff;
-		int teamScored;
-		int teamMissed;
-		int teamGameAm;
-
-	public:
-		Team(): teamPoints(0), teamWins(0), teamDraws(0), teamLoses(0), teamGoalDiff(0), teamScored(0), teamMissed(0), teamGameAm(0){};
-		
-
-		//getter methods
-		string name() {
-			return teamName;
-		}
-		int points() {
-			return teamPoints;
-		}
-		int wins() {
-			return teamWins;
-		}
-		int draws() {
-			return teamDraws;
-		}
-		int loses() {
-			return teamLoses;
-		}
-		int goalDiff() {
-			return teamGoalDiff;
-		}
-		int scored() {
-			return teamScored;
-		}
-		int missed() {
-			return teamMissed;
-		}
-		int gameAm() {
-			return teamGameAm;
-		}
-
+//the number at the beginning of the text, the way atoi reads it (spaces, a sign, digits)
+int readScore(const char* text, const char* end) {
+	while (text < end && isspace((unsigned char)*text))
+		text++;
+	bool negative = false;
+	if (text < end && (*text == '-' || *text == '+'))
+		negative = (*text++ == '-');
+	int value = 0;
+	while (text < end && *text >= '0' && *text <= '9')
+		value = value*10 + (*text++ - '0');
+	return negative ? -value : value;
+}
 
 
-		//setter methods
-		void name (string val) {
-			teamName = val;
+//this function parses the input string in which the results of the single match are recorded:
+//team1#goals1@goals2#team2, where the first team ends at the first '#' and the second starts after the last '#'
+void game(const char* line, size_t length, slice& team1, int& goals1, int& goals2, slice& team2) {
+	const char* end = line + length;
+	const char* first = (const char*)memchr(line, '#', length);
+	const char* at = (const char*)memchr(line, '@', length);
+	const char* last = first;
+	for (const char* c = end; c > line; c--)
+		if (c[-1] == '#') {
+			last = c-1;
+			break;
 		}
-		void points(int val) {
-			teamPoints = val;
-		}
-		void wins(int val) {
-			teamWins = val;
-		}
-		void draws(int val) {
-			teamDraws = val;
-		}
-		void loses(int val) {
-			teamLoses = val;
-		}
-		void goalDiff(int val) {
-			teamGoalDiff = val;
-		}
-		void scored(int val) {
-			teamScored = val;
-		}
-		void missed(int val) {
-			teamMissed = val;
-		}
-		void gameAm(int val) {
-			teamGameAm = val;
-		}
-};
 
-
-//this function parses the input string in which the results of the single match are recorded
-string* game(string s) {
-	int curr1 = s.find('#');
-	int curr2 = s.find('@');
-	int curr3 = s.find_last_of('#');
-	string* results = new string[4];
-	results[0] = s.substr(0, curr1);
-	results[1] = s.substr(curr1+1, curr2 - curr1-1);
-	results[2] = s.substr(curr2+1, curr3 - curr2-1);
-	results[3] = s.substr(curr3+1, s.size() - curr3-1);
-	return results;
+	team1.text = line;
+	team1.length = first ? first - line : length;
+	team2.text = last ? last + 1 : line;
+	team2.length = end - team2.text;
+	goals1 = readScore(first ? first + 1 : line, end);
+	goals2 = readScore(at ? at + 1 : line, end);
 }
 
 
@@ -116,172 +62,466 @@ string caseCheck(string s1) {
 
 
 
-//a block of funtions which compare the teams by different characteristics
-//test 3 to check if sorting by all these values works
-bool byName(Team t1, Team t2) {
-	if (strcmp(caseCheck(t1.name()).c_str(), caseCheck(t2.name()).c_str())>=0) return true;
-	else return false;
+//number of bits needed to hold the values 0..range
+int bitsFor(unsigned long long range) {
+	int bits = 0;
+	while (bits < 64 && (range >> bits) != 0)
+		bits++;
+	return bits;
 }
 
-bool byPoints(Team t1, Team t2) {
-	return t1.points() >= t2.points();
+
+//LSD radix sort of the keys by bytes, the team numbers go along; only the bytes the keys use are sorted
+void radixSort(vector<pair<unsigned long long, int> >& keys, int bits) {
+	vector<pair<unsigned long long, int> > tmp(keys.size());
+	for (int shift = 0; shift < bits; shift += 8) {
+		size_t count[257] = {0};
+		for (size_t i=0; i<keys.size(); i++)
+			count[((keys[i].first >> shift) & 0xFF) + 1]++;
+		for (int d=0; d<256; d++)
+			count[d+1] += count[d];
+		for (size_t i=0; i<keys.size(); i++)
+			tmp[count[(keys[i].first >> shift) & 0xFF]++] = keys[i];
+		keys.swap(tmp);
+	}
 }
 
-bool byWins(Team t1, Team t2) {
-	return t1.wins() >= t2.wins();
+
+//ranks the teams: by points, wins, goal difference and goals scored (the more the better), then by the games
+//played (the fewer the better), then by the name ignoring case from Z to A (a team that hasn't played has no name);
+//the teams that are equal in all of this are ordered by their names from Z to A, case sensitive
+//test 3 to check if sorting by all these values works
+//every team gets one key with these criteria packed from the most important in the highest bits, so the teams
+//are sorted once (with a radix sort for large tournaments); order gets the numbers of the teams from the first place
+void rankTeams(const TeamTable& teams, vector<int>& order) {
+	int count = teams.size();
+	order.resize(count);
+	for (int i=0; i<count; i++)
+		order[i] = i;
+	if (count < 2)
+		return;
+
+	//the place of every team among the names; the names are lowercased once, not on every comparison
+	sort(order.begin(), order.end(), [&teams](int a, int b) {
+		return strcmp(teams.name(a).c_str(), teams.name(b).c_str()) > 0;
+	});
+	vector<string> folded(count);
+	for (int i=0; i<count; i++)
+		if (teams.gameAm[i] > 0)
+			folded[i] = caseCheck(teams.name(i));
+	stable_sort(order.begin(), order.end(), [&folded](int a, int b) {
+		return strcmp(folded[a].c_str(), folded[b].c_str()) > 0;
+	});
+	vector<int> nameRank(count);
+	for (int i=0; i<count; i++)
+		nameRank[order[i]] = i;
+
+	//the criteria of every team, each turned so that the smaller value is the better team
+	const int FIELDS = 6;
+	vector<long long> field((size_t)FIELDS*count);
+	for (int i=0; i<count; i++) {
+		long long* f = &field[(size_t)i*FIELDS];
+		f[0] = -(long long)teams.points[i];
+		f[1] = -(long long)teams.wins[i];
+		f[2] = -(long long)teams.goalDiff[i];
+		f[3] = -(long long)teams.scored[i];
+		f[4] = teams.gameAm[i];
+		f[5] = nameRank[i];
+	}
+	long long low[FIELDS];
+	int bits[FIELDS];
+	int totalBits = 0;
+	for (int k=0; k<FIELDS; k++) {
+		long long high = field[k];
+		low[k] = field[k];
+		for (int i=1; i<count; i++) {
+			low[k] = min(low[k], field[(size_t)i*FIELDS+k]);
+			high = max(high, field[(size_t)i*FIELDS+k]);
+		}
+		bits[k] = bitsFor((unsigned long long)(high - low[k]));
+		totalBits += bits[k];
+	}
+
+	if (totalBits <= 64) {
+		vector<pair<unsigned long long, int> > keys(count);
+		for (int i=0; i<count; i++) {
+			unsigned long long key = 0;
+			for (int k=0; k<FIELDS; k++)
+				if (bits[k] > 0)
+					key = (key << bits[k]) | (unsigned long long)(field[(size_t)i*FIELDS+k] - low[k]);
+			keys[i] = make_pair(key, i);
+		}
+		//the name is in every key, so no two keys are equal
+		if (count < RADIX_SORT_TEAMS)
+			sort(keys.begin(), keys.end());
+		else
+			radixSort(keys, totalBits);
+		for (int i=0; i<count; i++)
+			order[i] = keys[i].second;
+	}
+	else {
+		//the values are too far apart to be packed together, so the criteria are compared one by one
+		sort(order.begin(), order.end(), [&field, FIELDS](int a, int b) {
+			return lexicographical_compare(&field[(size_t)a*FIELDS], &field[(size_t)(a+1)*FIELDS],
+				&field[(size_t)b*FIELDS], &field[(size_t)(b+1)*FIELDS]);
+		});
+	}
 }
 
-bool byGoalDiff(Team t1, Team t2) {
-	return t1.goalDiff() >= t2.goalDiff();
+
+//prints the line of the table for the team at the place
+void printTeam(ostream& f2, int place, const TeamTable& teams, int t) {
+	f2 << place << ") " << (teams.gameAm[t] > 0 ? teams.name(t).c_str() : "") << ' ' << teams.points[t] << "p, " << teams.gameAm[t] << "g (" << teams.wins[t] << '-' << teams.draws[t] << '-' << teams.loses[t] << "), " << teams.scored[t] - teams.missed[t] << "gd (" << teams.scored[t] << '-' << teams.missed[t] << ')' << endl;
 }
 
-bool byScored(Team t1, Team t2) {
-	return t1.scored() >= t2.scored();
+//the same line for the results a team had after some match
+void printRecord(ostream& f2, int place, const TeamTable& teams, const teamRecord& r) {
+	f2 << place << ") " << (r.gameAm > 0 ? teams.name(r.team).c_str() : "") << ' ' << r.points << "p, " << r.gameAm << "g (" << r.wins << '-' << r.draws << '-' << r.loses << "), " << r.scored - r.missed << "gd (" << r.scored << '-' << r.missed << ')' << endl;
 }
 
-bool byGames(Team t1, Team t2) {
-	return t1.gameAm() <= t2.gameAm();
+
+//answers a question about the live standings:
+//	?table		the whole table as it is now
+//	?top n		the first n places
+//	?rank name	the place of the team
+void liveQuery(ostream& f2, const char* line, const TeamTable& teams, const Standings& standings, vector<int>& order) {
+	if (strncmp(line, "?rank ", 6) == 0) {
+		int t = teams.find(line+6, strlen(line+6));
+		if (t == -1)
+			f2 << line+6 << " is not in the tournament" << endl;
+		else
+			f2 << line+6 << " is " << standings.place(t) << " of " << standings.size() << endl;
+		return;
+	}
+	int n = standings.size();
+	if (strncmp(line, "?top ", 5) == 0)
+		n = atoi(line+5);
+	standings.top(n, order);
+	for (size_t k=0; k<order.size(); k++)
+		printTeam(f2, k+1, teams, order[k]);
 }
 
 
+//answers a question about the standings after some match of the tournament:
+//	?at r			the table after the first r matches
+//	?at r top n		the first n places of it
+//	?at r rank name	the place of the team in it
+void historyQuery(ostream& f2, const char* line, const TeamTable& teams, const StandingsHistory& history, vector<int>& records) {
+	char* rest;
+	long r = strtol(line+4, &rest, 10);
+	int version = (int)max(0L, min(r, (long)history.current()));
+	while (*rest == ' ')
+		rest++;
+	if (strncmp(rest, "rank ", 5) == 0) {
+		int t = teams.find(rest+5, strlen(rest+5));
+		int place = (t == -1) ? 0 : history.place(version, t);
+		if (place == 0)
+			f2 << rest+5 << " is not in the tournament" << endl;
+		else
+			f2 << rest+5 << " is " << place << " of " << history.size(version) << endl;
+		return;
+	}
+	int n = history.size(version);
+	if (strncmp(rest, "top ", 4) == 0)
+		n = atoi(rest+4);
+	history.top(version, n, records);
+	for (size_t k=0; k<records.size(); k++)
+		printRecord(f2, k+1, teams, history.record(records[k]));
+}
 
 
-//merge sorting function for the team class. This sort is known to be stable. Gets the pointer to the necessary compare function
-Team* merge_sort(Team* arr, Team* tmp, int left, int right, bool (*compare)(Team, Team)) {
-	if (left >= right)
-		return arr+left; 
-	else {
-		int mid = (int)((left+right)/2);
-		Team* leftArr = merge_sort(arr, tmp, left, mid, compare);
-		Team* rightArr = merge_sort(arr, tmp, mid+1, right, compare);
-
-		int i = left;
-		int j = mid+1;
-		for (int k = 0; k < right-left+1; k++) {
-			if ((i <= mid) && (j <= right)) {
-				if (compare(arr[i],arr[j])) {
-					tmp[k] = arr[i];
-					i++;
-				}
-				else {
-					tmp[k] = arr[j];
-					j++;
-				}
-			}
-			else {
-				if (i>mid)
-					tmp[k] = arr[j++];
-				else
-					tmp[k] = arr[i++];
-			}
-		}
-		for (int k = 0; k < right-left+1; k++)
-			arr[k+left] = tmp[k];
-		return arr+left;
+void readTournament(ifstream& f, char* buff, tournamentJob& job) {
+	//inputing the name of the tournament
+	f.getline(buff, 100,'\n');
+	job.title.assign(buff);
+
+	int K = 0;
+	f >> K;
+	f.getline(buff, 1,'\n');
+	job.teamCount = max(K, 0);
+	if ((int)job.teamLines.size() < job.teamCount)
+		job.teamLines.resize(job.teamCount);
+	for (int j=0; j<K; j++)
+	{
+		f.getline(buff, 100,'\n');
+		job.teamLines[j].assign(buff);
+	}
+
+	int G=0;
+	f >> G;
+	f.getline(buff, 1,'\n');
+	job.matchCount = max(G, 0);
+	if ((int)job.matchLines.size() < job.matchCount)
+		job.matchLines.resize(job.matchCount);
+	for (int j=0; j<G; j++)
+	{
+		f.getline(buff, 100,'\n');
+		job.matchLines[j].assign(buff);
 	}
 }
 
 
-//functor for comparing to strings (because there's no < in a string class) so as to make map work with a string class as a key
-struct my_strcmp {
-	bool operator()(const string& str1, const string& str2) {
-		return (strcmp(str1.c_str(), str2.c_str()) > 0) ? true : false;
+void solveTournament(const tournamentJob& job, TeamTable& teams, vector<int>& order, ostream& out) {
+	teams.clear();
+	for (int j=0; j<job.teamCount; j++)
+		teams.id(job.teamLines[j].data(), job.teamLines[j].size());
+
+	//parcing the input values of the matches
+	for (int j=0; j<job.matchCount; j++) {
+		slice team1, team2;
+		int sc1, sc2;
+		game(job.matchLines[j].data(), job.matchLines[j].size(), team1, sc1, sc2, team2);
+		int t1 = teams.id(team1.text, team1.length);
+		int t2 = teams.id(team2.text, team2.length);
+		teams.addMatch(t1, sc1, t2, sc2);
 	}
+
+	rankTeams(teams, order);
+
+	//output
+	out << job.title.c_str() << endl;
+	for (int k=0; k<teams.size(); k++)
+		printTeam(out, k+1, teams, order[k]);
+	out << endl;
+}
+
+
+//a match line cut into its parts, for the timed solution
+struct parsedMatch {
+	slice team1, team2;
+	int goals1, goals2;
 };
 
+//the time taken by every step of the solution, added up over the tournaments
+struct tournamentTimes {
+	chrono::steady_clock::duration read, parse, aggregate, rank, write;
+	long long teams, matches;
+};
 
 
-int main()
+//the same as solveTournament, one step after the other so that every step can be timed: all the match lines
+//are cut first, then added up in the table, then ranked
+void solveTimed(const tournamentJob& job, TeamTable& teams, vector<int>& order, vector<parsedMatch>& matches, ostream& out, tournamentTimes& times) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if ((int)matches.size() < job.matchCount)
+		matches.resize(job.matchCount);
+	for (int j=0; j<job.matchCount; j++) {
+		parsedMatch& m = matches[j];
+		game(job.matchLines[j].data(), job.matchLines[j].size(), m.team1, m.goals1, m.goals2, m.team2);
+	}
+	chrono::steady_clock::time_point parsed = chrono::steady_clock::now();
+
+	teams.clear();
+	for (int j=0; j<job.teamCount; j++)
+		teams.id(job.teamLines[j].data(), job.teamLines[j].size());
+	for (int j=0; j<job.matchCount; j++) {
+		const parsedMatch& m = matches[j];
+		int t1 = teams.id(m.team1.text, m.team1.length);
+		int t2 = teams.id(m.team2.text, m.team2.length);
+		teams.addMatch(t1, m.goals1, t2, m.goals2);
+	}
+	chrono::steady_clock::time_point aggregated = chrono::steady_clock::now();
+
+	rankTeams(teams, order);
+	chrono::steady_clock::time_point ranked = chrono::steady_clock::now();
+
+	out << job.title.c_str() << endl;
+	for (int k=0; k<teams.size(); k++)
+		printTeam(out, k+1, teams, order[k]);
+	out << endl;
+
+	times.parse += parsed - start;
+	times.aggregate += aggregated - parsed;
+	times.rank += ranked - aggregated;
+	times.write += chrono::steady_clock::now() - ranked;
+	times.teams += teams.size();
+	times.matches += job.matchCount;
+}
+
+
+//with the option -live the standings are kept up to date after every match (see Standings.cpp) instead of being
+//ranked at the end, and the lines of the matches may be mixed with questions starting with '?' (see liveQuery),
+//which are answered in the output before the final table
+//with the option -history the standings after every match are kept (see History.cpp), and the questions about them
+//that follow the matches of a tournament (lines starting with '?at', see historyQuery) are answered before its table
+//with the option -time the tournaments are solved one by one and the time of reading the input, cutting the match
+//lines, adding them up and ranking the teams is printed to the standard error, every step apart (see benchmark.sh)
+//with the option -threads n the tournaments are solved on n threads at once (see TournamentBatch.cpp)
+//with the option -log file the table of a single tournament is made of a file with nothing but match lines,
+//added up on the number of threads given by -threads (see MatchLog.cpp), and titled with the name of the file
+int main(int argc, char* argv[])
 {
+	bool live = false, history = false, timed = false;
+	const char* log = 0;
+	int threads = 0; //not given
+	for (int i=1; i<argc; i++) {
+		if (strcmp(argv[i], "-live") == 0)
+			live = true;
+		else if (strcmp(argv[i], "-history") == 0)
+			history = true;
+		else if (strcmp(argv[i], "-time") == 0)
+			timed = true;
+		else if (strcmp(argv[i], "-log") == 0 && i+1 < argc)
+			log = argv[++i];
+		else if (strcmp(argv[i], "-threads") == 0 && i+1 < argc)
+			threads = atoi(argv[++i]);
+	}
+
+	if (log != 0) {
+		TeamTable teams;
+		vector<int> order;
+		if (!readMatchLog(log, threads > 0 ? threads : thread::hardware_concurrency(), teams)) {
+			fprintf(stderr, "Error: %s could not be read\n", log);
+			return 1;
+		}
+		rankTeams(teams, order);
+		ofstream f2("output.txt", ios::out);
+		f2 << log << endl;
+		for (int k=0; k<teams.size(); k++)
+			printTeam(f2, k+1, teams, order[k]);
+		f2 << endl;
+		return 0;
+	}
+
 	ifstream f("input.txt", ios::in);
 	ofstream f2("output.txt", ios::out);
 	int N = 0;
 	f >> N;
 	char* buff = new char[1000];
 	f.getline(buff, 1,'\n');
+	//the table of the teams and the ranking, reused by all the tournaments
+	TeamTable teams;
+	vector<int> order;
+
+	if (history) {
+		tournamentJob job;
+		StandingsHistory versions;
+		for (int i=0; i<N; i++) {
+			readTournament(f, buff, job);
+			teams.clear();
+			versions.clear(&teams);
+			for (int j=0; j<job.teamCount; j++) {
+				int known = teams.size();
+				int t = teams.id(job.teamLines[j].data(), job.teamLines[j].size());
+				if (teams.size() > known)
+					versions.addTeam(t);
+			}
+			for (int j=0; j<job.matchCount; j++) {
+				slice team1, team2;
+				int sc1, sc2;
+				game(job.matchLines[j].data(), job.matchLines[j].size(), team1, sc1, sc2, team2);
+				int t1 = teams.id(team1.text, team1.length);
+				int t2 = teams.id(team2.text, team2.length);
+				versions.addMatch(t1, sc1, t2, sc2);
+			}
+
+			f2 << job.title.c_str() << endl;
+			while (f.peek() == '?') {
+				f.getline(buff, 100,'\n');
+				historyQuery(f2, buff, teams, versions, order);
+			}
+			versions.top(versions.current(), versions.size(versions.current()), order);
+			for (size_t k=0; k<order.size(); k++)
+				printRecord(f2, k+1, teams, versions.record(order[k]));
+			f2 << endl;
+		}
+		return 0;
+	}
+
+	if (timed) {
+		tournamentJob job;
+		vector<parsedMatch> matches;
+		tournamentTimes times;
+		times.read = times.parse = times.aggregate = times.rank = times.write = chrono::steady_clock::duration(0);
+		times.teams = times.matches = 0;
+		for (int i=0; i<N; i++) {
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			readTournament(f, buff, job);
+			times.read += chrono::steady_clock::now() - start;
+			solveTimed(job, teams, order, matches, f2, times);
+		}
+		cerr << "tournaments " << N << " teams " << times.teams << " matches " << times.matches
+			<< " read_ms " << chrono::duration<double, milli>(times.read).count()
+			<< " parse_ms " << chrono::duration<double, milli>(times.parse).count()
+			<< " aggregate_ms " << chrono::duration<double, milli>(times.aggregate).count()
+			<< " rank_ms " << chrono::duration<double, milli>(times.rank).count()
+			<< " write_ms " << chrono::duration<double, milli>(times.write).count() << endl;
+		return 0;
+	}
+
+	if (!live) {
+		if (threads > 1) {
+			solveBatch(f, buff, N, threads, f2);
+		}
+		else {
+			tournamentJob job;
+			for (int i=0; i<N; i++) {
+				readTournament(f, buff, job);
+				solveTournament(job, teams, order, f2);
+			}
+		}
+		return 0;
+	}
+
+	Standings standings;
 	for (int i=0; i<N; i++) {
 		//inputing the name of the tournament
 		f.getline(buff, 100,'\n');
 		string tourn(buff);
+		f2 << tourn.c_str() << endl;
 		int K = 0;
-		//creating map to quickly find values when we read the results of the matches
-		map<string, Team, my_strcmp> teams;
+		teams.clear();
+		standings.clear(&teams);
 		f >> K;
 		f.getline(buff, 1,'\n');
 		for (int j=0; j<K; j++)
 		{
 			f.getline(buff, 100,'\n');
-			string name(buff);
-			teams[name];
+			int known = teams.size();
+			int t = teams.id(buff, strlen(buff));
+			if (teams.size() > known)
+				standings.insert(t);
 		}
 
 		int G=0;
 		f >> G;
 		f.getline(buff, 1,'\n');
 
-		//parcing the input values of the matches
+		//parcing the input values of the matches, with the questions among them
 		for (int j=0; j<G; j++)
 		{
 			f.getline(buff, 100,'\n');
+			if (buff[0] == '?') {
+				liveQuery(f2, buff, teams, standings, order);
+				j--; //a question is not a match
+				continue;
+			}
 			//parsing the string with the results of the match
-			string* results = game(string(buff));
-			int sc1 = atoi((*(results+1)).c_str());
-			int sc2 = atoi((*(results+2)).c_str());
-			teams[results[0]].scored(teams[results[0]].scored() + sc1);
-			teams[results[0]].goalDiff(teams[results[0]].goalDiff() + sc1 - sc2);
-			teams[results[0]].gameAm(teams[results[0]].gameAm() + 1);
-			teams[results[0]].missed(teams[results[0]].missed() + sc2);
-			teams[results[0]].name(*results);
-			if (sc1 > sc2) {
-					teams[results[0]].wins(teams[results[0]].wins()+1);
-					teams[results[0]].points(teams[results[0]].points() + 3);
-					teams[results[3]].loses(teams[results[3]].loses()+1);
-				}
-			else
-				{
-				if (sc2 > sc1) {
-					teams[results[3]].wins(teams[results[3]].wins()+1);
-					teams[results[0]].loses(teams[results[0]].loses()+1);
-					teams[results[3]].points(teams[results[3]].points() + 3);
-					}
-				else {
-					teams[results[0]].draws(teams[results[0]].draws()+1);
-					teams[results[3]].draws(teams[results[3]].draws()+1);
-					teams[results[0]].points(teams[results[0]].points()+1);
-					teams[results[3]].points(teams[results[3]].points()+1);
-					}
-				}
-			teams[results[3]].scored(teams[results[3]].scored() + sc2);
-			teams[results[3]].goalDiff(teams[results[3]].goalDiff() + sc2 - sc1);
-			teams[results[3]].gameAm(teams[results[3]].gameAm()+1);
-			teams[results[3]].missed(teams[results[3]].missed() + sc1);
-			teams[results[3]].name(*(results+3));
+			slice team1, team2;
+			int sc1, sc2;
+			game(buff, strlen(buff), team1, sc1, sc2, team2);
+			int known = teams.size();
+			int t1 = teams.id(team1.text, team1.length);
+			if (teams.size() > known)
+				standings.insert(t1);
+			known = teams.size();
+			int t2 = teams.id(team2.text, team2.length);
+			if (teams.size() > known)
+				standings.insert(t2);
+			standings.addMatch(t1, sc1, t2, sc2);
 		}
 
-		Team* arr = new Team[teams.size()];
-		Team* tmp = new Team[teams.size()];
-		int count=0;
-
-		//putting the values from the map to the ordinary array of teams which will be easier to sort
-		for (auto it = teams.begin(); it != teams.end(); it++, count++)
-			arr[count] = (*it).second;
-
-		//an array of compare functions
-		bool (*comparators[])(Team, Team) = {
-			byName, byGames, byScored, byGoalDiff, byWins, byPoints
-		};
-
-		//sorting the array with a stable sort function
-		for (int j=0; j<6; j++)
-			merge_sort(arr, tmp, 0, teams.size()-1, comparators[j]);
+		//the questions after the last match
+		while (f.peek() == '?') {
+			f.getline(buff, 100,'\n');
+			liveQuery(f2, buff, teams, standings, order);
+		}
 
 		//output
-		f2 << tourn.c_str() << endl;
-		for (int k=0; k<count; k++) {
-			f2 << (k+1) << ") " << arr[k].name().c_str() << ' ' << arr[k].points() << "p, " << arr[k].gameAm() << "g (" << arr[k].wins() << '-' << arr[k].draws() << '-' << arr[k].loses() << "), " << arr[k].scored() - arr[k].missed() << "gd (" << arr[k].scored() << '-' << arr[k].missed() << ')' << endl;
-		}
+		standings.top(standings.size(), order);
+		for (int k=0; k<teams.size(); k++)
+			printTeam(f2, k+1, teams, order[k]);
 		f2 << endl; 
 	}
 	return 0;
 }
-
@@ -0,0 +1,305 @@
+//Tournament.h : the table of the teams and the rankings of a tournament
+//Author: Tigunova Anna
+
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+//from this many teams the ranking uses a radix sort instead of a comparison sort
+#define RADIX_SORT_TEAMS 256
+
+
+//the teams of a tournament: every name gets a number the first time it is seen, through an open addressing
+//hash table of the names, and the results of the teams are kept in flat arrays under these numbers;
+//the table keeps its memory from one tournament to the next; the results are 64 bit so that a whole season
+//of a league can be added up
+class TeamTable
+{
+	public:
+		std::vector<long long> points, wins, draws, loses, goalDiff, scored, missed, gameAm;
+
+		TeamTable(): count(0) {};
+
+		//empties the table; the hash table is sized for as many teams as the last tournament had, so that a
+		//large tournament doesn't make the small ones after it pay for clearing a large table
+		void clear() {
+			size_t wanted = 64;
+			while (wanted < 2*(size_t)count)
+				wanted *= 2;
+			count = 0;
+			slots.assign(wanted, -1);
+		}
+
+		int size() const {
+			return count;
+		}
+
+		//the name the team is known by (as it was first seen)
+		const std::string& name(int id) const {
+			return names[id];
+		}
+
+		//the number of the team with this name, a new one if the name hasn't been seen
+		int id(const char* name, size_t length) {
+			if (slots.empty())
+				clear();
+			unsigned h = hash(name, length);
+			size_t i = slotOf(name, length, h);
+			if (slots[i] != -1)
+				return slots[i];
+			if (2*(count + 1) > (int)slots.size()) {
+				grow();
+				i = slotOf(name, length, h);
+			}
+			slots[i] = add(name, length, h);
+			return slots[i];
+		}
+
+		//the number of the team with this name, -1 if there's no such team
+		int find(const char* name, size_t length) const {
+			if (slots.empty())
+				return -1;
+			return slots[slotOf(name, length, hash(name, length))];
+		}
+
+		//adds the results of all the teams of another table (of other matches of the same tournament)
+		void merge(const TeamTable& other) {
+			for (int o=0; o<other.count; o++) {
+				int t = id(other.names[o].data(), other.names[o].size());
+				points[t] += other.points[o];
+				wins[t] += other.wins[o];
+				draws[t] += other.draws[o];
+				loses[t] += other.loses[o];
+				goalDiff[t] += other.goalDiff[o];
+				scored[t] += other.scored[o];
+				missed[t] += other.missed[o];
+				gameAm[t] += other.gameAm[o];
+			}
+		}
+
+		//adds the result of one match to both teams
+		void addMatch(int team1, int goals1, int team2, int goals2) {
+			scored[team1] += goals1;
+			missed[team1] += goals2;
+			goalDiff[team1] += goals1 - goals2;
+			gameAm[team1]++;
+			scored[team2] += goals2;
+			missed[team2] += goals1;
+			goalDiff[team2] += goals2 - goals1;
+			gameAm[team2]++;
+			if (goals1 > goals2) {
+				wins[team1]++;
+				points[team1] += 3;
+				loses[team2]++;
+			}
+			else if (goals2 > goals1) {
+				wins[team2]++;
+				points[team2] += 3;
+				loses[team1]++;
+			}
+			else {
+				draws[team1]++;
+				draws[team2]++;
+				points[team1]++;
+				points[team2]++;
+			}
+		}
+
+	private:
+		int count;
+		std::vector<std::string> names;
+		std::vector<unsigned> hashes;
+		std::vector<int> slots; //a power of two of them, -1 if empty, at most half are used
+
+		//FNV-1a
+		static unsigned hash(const char* name, size_t length) {
+			unsigned h = 2166136261u;
+			for (size_t i=0; i<length; i++) {
+				h ^= (unsigned char)name[i];
+				h *= 16777619u;
+			}
+			return h;
+		}
+
+		//the slot of the name, or the empty slot where it would go
+		size_t slotOf(const char* name, size_t length, unsigned h) const {
+			size_t mask = slots.size() - 1;
+			size_t i = h & mask;
+			while (slots[i] != -1) {
+				int t = slots[i];
+				if (hashes[t] == h && names[t].size() == length && memcmp(names[t].data(), name, length) == 0)
+					break;
+				i = (i + 1) & mask;
+			}
+			return i;
+		}
+
+		int add(const char* name, size_t length, unsigned h) {
+			if ((int)names.size() == count) {
+				names.push_back(std::string());
+				hashes.push_back(0);
+				points.push_back(0); wins.push_back(0); draws.push_back(0); loses.push_back(0);
+				goalDiff.push_back(0); scored.push_back(0); missed.push_back(0); gameAm.push_back(0);
+			}
+			names[count].assign(name, length);
+			hashes[count] = h;
+			points[count] = wins[count] = draws[count] = loses[count] = 0;
+			goalDiff[count] = scored[count] = missed[count] = gameAm[count] = 0;
+			return count++;
+		}
+
+		void grow() {
+			slots.assign(slots.size() * 2, -1);
+			size_t mask = slots.size() - 1;
+			for (int t=0; t<count; t++) {
+				size_t i = hashes[t] & mask;
+				while (slots[i] != -1)
+					i = (i + 1) & mask;
+				slots[i] = t;
+			}
+		}
+};
+
+
+//a piece of the line, not copied
+struct slice {
+	const char* text;
+	size_t length;
+};
+
+
+//the number at the beginning of the text, the way atoi reads it (spaces, a sign, digits)
+int readScore(const char* text, const char* end);
+
+//this function parses the input string in which the results of the single match are recorded:
+//team1#goals1@goals2#team2, where the first team ends at the first '#' and the second starts after the last '#'
+void game(const char* line, size_t length, slice& team1, int& goals1, int& goals2, slice& team2);
+
+//this function transforms the string to lowercase to make case-insensitive sort of team names
+std::string caseCheck(std::string s1);
+
+//adds up the matches of a match log, a file of nothing but match lines, on the given number of threads
+//(see MatchLog.cpp); false if the file can't be read
+bool readMatchLog(const char* name, int threads, TeamTable& teams);
+
+//ranks all the teams at once; order gets the numbers of the teams from the first place
+void rankTeams(const TeamTable& teams, std::vector<int>& order);
+
+
+//the standings kept up to date while the matches come in: the teams are kept in an order statistics tree
+//(a treap that knows the size of every subtree) in the order of rankTeams, so a match only takes its two teams
+//out and puts them back in O(log n), and the place of a team or the first n teams are found in O(log n) (+ n)
+//without sorting anything
+class Standings
+{
+	public:
+		//empties the standings of the table, which has to live as long as they do
+		void clear(TeamTable* table);
+
+		//a team of the table that is not in the standings yet
+		void insert(int team);
+
+		//adds the result of one match to the table and moves both teams to their new places
+		void addMatch(int team1, int goals1, int team2, int goals2);
+
+		int size() const;
+
+		//the place of the team, from 1
+		int place(int team) const;
+
+		//the numbers of the first n teams
+		void top(int n, std::vector<int>& order) const;
+
+	private:
+		bool before(int a, int b) const;
+		int split(int node, int team, int& right);
+		int merge(int a, int b);
+		int erase(int node, int team);
+		void update(int node);
+
+		TeamTable* teams;
+		int root;
+		std::vector<int> left, right, sizes; //-1 for no child
+		std::vector<unsigned> priority;
+		std::vector<std::string> folded; //the lowercased name the team is ranked by, empty until it plays
+};
+
+
+//the results of a team after some match, as the standings history keeps them
+struct teamRecord {
+	int team;
+	long long points, wins, draws, loses, goalDiff, scored, missed, gameAm;
+	int left, right, size; //the tree of the version, -1 for no child
+};
+
+
+//the standings after every match of a tournament: every version is a treap of records ordered as rankTeams orders
+//the teams, and a match makes a new version by copying only the paths to the two records it changes (path copying),
+//so a version costs O(log n) records and all the earlier versions stay as they were; the table of any version,
+//the first k places of it or the place of a team in it are read in O(log n + k) without replaying the matches
+class StandingsHistory
+{
+	public:
+		//starts the history of the tournament of the table, which has to live as long as the history
+		void clear(const TeamTable* table);
+
+		//a new team with no results, in the current version (the teams listed before the matches)
+		void addTeam(int team);
+
+		//a new version: the current one with the result of the match; the teams that weren't added join with it
+		void addMatch(int team1, int goals1, int team2, int goals2);
+
+		//the number of the current version, which is the number of matches so far
+		int current() const;
+
+		int size(int version) const;
+
+		//the records of the first n teams of the version
+		void top(int version, int n, std::vector<int>& records) const;
+
+		//the place of the team in the version, from 1; 0 if the team hadn't appeared yet
+		int place(int version, int team) const;
+
+		const teamRecord& record(int r) const {
+			return records[r];
+		}
+
+	private:
+		bool before(const teamRecord& a, const teamRecord& b) const;
+		teamRecord newRecord(int team);
+		int copy(int r);
+		void update(int r);
+		int split(int node, teamRecord key, int& rest);
+		int merge(int a, int b);
+		int erase(int node, teamRecord key);
+		int insert(int node, int r);
+
+		const TeamTable* teams;
+		std::vector<teamRecord> records;
+		std::vector<int> roots; //the root of every version
+		std::vector<std::vector<std::pair<int, int> > > history; //(version, record) of every team, the versions ascending
+		std::vector<std::string> folded;
+};
+
+
+//one tournament of input.txt as it was read, to be solved on its own; the lines are kept from one
+//tournament to the next so that reading doesn't allocate once they are long enough
+struct tournamentJob {
+	std::string title;
+	std::vector<std::string> teamLines, matchLines;
+	int teamCount, matchCount;
+};
+
+//reads the next tournament the way the lines have always been read
+void readTournament(std::ifstream& f, char* buff, tournamentJob& job);
+
+//ranks the tournament and writes its block of the output
+void solveTournament(const tournamentJob& job, TeamTable& teams, std::vector<int>& order, std::ostream& out);
+
+//solves the N tournaments of the input on a number of threads and writes them in their order (see TournamentBatch.cpp)
+void solveBatch(std::ifstream& f, char* buff, int N, int threads, std::ostream& out);
@@ -0,0 +1,107 @@
+//TournamentBatch.cpp : many tournaments of one input solved at the same time
+//Author: Tigunova Anna
+
+#include "stdafx.h"
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "Tournament.h"
+using namespace std;
+
+
+//the main thread reads the tournaments into a ring of slots, the workers solve them, each with its own table
+//of the teams that it keeps for all its tournaments, and the main thread writes the output of the slots in
+//their order; a slot (with its lines and its output) is reused as soon as it is written, so nothing is allocated
+//per tournament once the slots have grown to the size of the tournaments
+
+
+struct batchSlot {
+	tournamentJob job;
+	ostringstream out;
+	bool solved;
+};
+
+struct batch {
+	vector<batchSlot> slots;
+	int read; //number of tournaments read so far
+	int taken; //number of them given to a worker
+	int written;
+	bool finished; //no more tournaments will be read
+
+	mutex lock;
+	condition_variable workReady; //a tournament has been read or the input is finished
+	condition_variable workDone; //a tournament has been solved
+};
+
+
+static void worker(batch* b) {
+	TeamTable teams;
+	vector<int> order;
+	unique_lock<mutex> guard(b->lock);
+
+	while (true) {
+		while (b->taken == b->read && !b->finished)
+			b->workReady.wait(guard);
+		if (b->taken == b->read)
+			break;
+		batchSlot& slot = b->slots[b->taken % b->slots.size()];
+		b->taken++;
+
+		//the slot isn't touched by anybody else before it is solved
+		guard.unlock();
+		slot.out.str("");
+		slot.out.clear();
+		solveTournament(slot.job, teams, order, slot.out);
+		guard.lock();
+
+		slot.solved = true;
+		b->workDone.notify_all();
+	}
+}
+
+
+void solveBatch(ifstream& f, char* buff, int N, int threads, ostream& out) {
+	batch b;
+	b.slots.resize(4*threads);
+	b.read = b.taken = b.written = 0;
+	b.finished = false;
+
+	vector<thread> workers;
+	for (int i=0; i<threads; i++)
+		workers.push_back(thread(worker, &b));
+
+	unique_lock<mutex> guard(b.lock);
+	while (b.written < b.read || !b.finished) {
+		//read ahead while there is a free slot
+		while (!b.finished && b.read - b.written < (int)b.slots.size()) {
+			if (b.read == N) {
+				b.finished = true;
+			}
+			else {
+				batchSlot& slot = b.slots[b.read % b.slots.size()];
+				guard.unlock();
+				readTournament(f, buff, slot.job);
+				guard.lock();
+				slot.solved = false;
+				b.read++;
+			}
+			b.workReady.notify_all();
+		}
+
+		//write the oldest tournament as soon as it is solved
+		if (b.written < b.read) {
+			batchSlot& slot = b.slots[b.written % b.slots.size()];
+			while (!slot.solved)
+				b.workDone.wait(guard);
+			guard.unlock();
+			out << slot.out.str();
+			guard.lock();
+			b.written++;
+		}
+	}
+
+	guard.unlock();
+	for (size_t i=0; i<workers.size(); i++)
+		workers[i].join();
+}
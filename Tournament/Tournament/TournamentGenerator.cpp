@@ -0,0 +1,122 @@
+//TournamentGenerator.cpp : generates large tournaments for Tournament, so that the parsing, the adding up and
+//the ranking can be timed on thousands and millions of teams
+//Author: Tigunova Anna
+//
+//usage: TournamentGenerator input|log teams matches min_name max_name tournaments seed output_file
+//
+//	input	the tournaments in the format of input.txt: the title, the teams, then the matches team1#goals1@goals2#team2
+//	log		nothing but the match lines of one tournament, as the option -log reads them
+//every team has a strength, and the goals of a side are drawn around the ratio of the strengths of the two teams,
+//so the table has leaders and outsiders and not just ties; the names are min_name .. max_name letters (with some
+//spaces inside) and end with the number of the team, so no two teams have the same name
+//the same seed always gives the same tournaments
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+//a line of input.txt is read into 100 characters, so two names and the score have to fit in it
+#define MAX_NAME 45
+#define MAX_GOALS 99
+
+
+static const char letters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+
+//random letters, then the number of the team in digits letters long
+static string teamName(int team, int digits, int length, mt19937_64& generator) {
+	string name(length, ' ');
+	for (int i=0; i<length-digits; i++)
+		if (i == 0 || generator() % 8 != 0)
+			name[i] = letters[generator() % 52];
+	for (int i=length-1; i>=length-digits; i--) {
+		name[i] = letters[team % 52];
+		team /= 52;
+	}
+	return name;
+}
+
+
+static void tournament(FILE* output, bool log, int t, int teams, long long matches, int minName, int maxName, mt19937_64& generator) {
+	int digits = 1;
+	for (long long n=52; n<teams; n*=52)
+		digits++;
+	if (minName < digits)
+		minName = digits;
+	if (maxName < minName)
+		maxName = minName;
+
+	vector<string> names(teams);
+	vector<double> strength(teams);
+	uniform_int_distribution<int> length(minName, maxName);
+	uniform_real_distribution<double> power(0.5, 2.0);
+	for (int i=0; i<teams; i++) {
+		names[i] = teamName(i, digits, length(generator), generator);
+		strength[i] = power(generator);
+	}
+
+	if (!log) {
+		fprintf(output, "Tournament %d\n%d\n", t+1, teams);
+		for (int i=0; i<teams; i++)
+			fprintf(output, "%s\n", names[i].c_str());
+		fprintf(output, "%lld\n", matches);
+	}
+
+	uniform_int_distribution<int> team(0, teams-1);
+	for (long long j=0; j<matches; j++) {
+		int a = team(generator);
+		int b = team(generator);
+		if (teams > 1)
+			while (b == a)
+				b = team(generator);
+		poisson_distribution<int> goalsA(1.35 * strength[a] / strength[b]);
+		poisson_distribution<int> goalsB(1.35 * strength[b] / strength[a]);
+		int ga = min(goalsA(generator), MAX_GOALS);
+		int gb = min(goalsB(generator), MAX_GOALS);
+		fprintf(output, "%s#%d@%d#%s\n", names[a].c_str(), ga, gb, names[b].c_str());
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc != 9) {
+		fprintf(stderr, "Usage: %s input|log teams matches min_name max_name tournaments seed output_file\n", argv[0]);
+		return 1;
+	}
+	bool log = strcmp(argv[1], "log") == 0;
+	if (!log && strcmp(argv[1], "input") != 0) {
+		fprintf(stderr, "Error: unknown format %s\n", argv[1]);
+		return 1;
+	}
+	int teams = atoi(argv[2]);
+	long long matches = atoll(argv[3]);
+	int minName = atoi(argv[4]);
+	int maxName = atoi(argv[5]);
+	int tournaments = log ? 1 : atoi(argv[6]);
+	unsigned long long seed = strtoull(argv[7], 0, 10);
+	if (teams < 1 || matches < 0 || minName < 1 || maxName > MAX_NAME || tournaments < 1) {
+		fprintf(stderr, "Error: there has to be a team, names of 1 .. %d letters and a tournament\n", MAX_NAME);
+		return 1;
+	}
+
+	FILE* output = fopen(argv[8], "w");
+	if (output == 0) {
+		fprintf(stderr, "Error: %s could not be opened\n", argv[8]);
+		return 1;
+	}
+
+	mt19937_64 generator(seed);
+	if (!log)
+		fprintf(output, "%d\n", tournaments);
+	for (int t=0; t<tournaments; t++)
+		tournament(output, log, t, teams, matches, minName, maxName, generator);
+
+	fclose(output);
+	return 0;
+}
@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# Benchmark of Tournament on large leagues: seeded tournaments of 10 .. 10^6 teams (TournamentGenerator.cpp)
+# are solved with -time, which reports the time of reading input.txt, cutting the match lines, adding them up and
+# ranking the teams apart from each other. The table is then solved again on every core (-threads) and from the
+# match log (-log), and every way has to give the same table; the checksum of the table is printed, so a change
+# of the ranking is accepted only if it keeps the checksums of the run before it. Run from this directory;
+# everything is built and written in ./benchmark (stdafx.h is Windows only, so the sources are built from a copy
+# next to an empty one)
+#
+#   bash benchmark.sh [largest_teams] [matches_per_team] [seed]
+
+LARGEST=${1:-1000000}
+PER_TEAM=${2:-10}
+SEED=${3:-2014}
+THREADS=$(nproc)
+
+mkdir -p benchmark
+cp Tournament.cpp Tournament.h Standings.cpp MatchLog.cpp TournamentBatch.cpp History.cpp TournamentGenerator.cpp benchmark || exit 1
+cd benchmark
+echo "#pragma once" > stdafx.h
+g++ -O2 -pthread -o tournament Tournament.cpp Standings.cpp MatchLog.cpp TournamentBatch.cpp History.cpp || exit 1
+g++ -O2 -o generator TournamentGenerator.cpp || exit 1
+
+echo "    teams    matches  read_ms  parse_ms aggregate_ms  rank_ms  write_ms  checksum"
+for TEAMS in 10 100 1000 10000 100000 1000000; do
+    if [ $TEAMS -gt $LARGEST ]; then
+        continue
+    fi
+    MATCHES=$((TEAMS * PER_TEAM))
+    ./generator input $TEAMS $MATCHES 4 20 1 $SEED input.txt || exit 1
+    ./generator log $TEAMS $MATCHES 4 20 1 $SEED log.txt || exit 1
+
+    ./tournament -time 2> time.txt || exit 1
+    TABLE=$(md5sum < output.txt | cut -c1-32)
+    awk -v checksum=$TABLE \
+        '{ printf "%9d %10d %8.2f %9.2f %12.2f %8.2f %9.2f  %s\n", $4, $6, $8, $10, $12, $14, $16, checksum }' time.txt
+
+    # the same table on every core and from the log, where only the title is different
+    ./tournament -threads $THREADS || exit 1
+    if [ "$TABLE" != "$(md5sum < output.txt | cut -c1-32)" ]; then
+        echo "the table of -threads $THREADS differs"
+        exit 1
+    fi
+    ./tournament -log log.txt -threads $THREADS || exit 1
+    sed -i 1s/.*/"Tournament 1"/ output.txt
+    if [ "$TABLE" != "$(md5sum < output.txt | cut -c1-32)" ]; then
+        echo "the table of -log differs"
+        exit 1
+    fi
+done
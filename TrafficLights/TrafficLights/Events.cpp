@@ -0,0 +1,133 @@
+//Events.cpp : the simulation of the traffic light from one event to the next instead of period by period,
+//so that it takes as long as there are arrivals, switches of the light and departures, however short the period is
+//Created by Anna Tigunova
+
+#include <algorithm>
+#include <vector>
+#include "Traffic.h"
+using namespace std;
+
+
+//the kinds of events; the events of the same period happen in this order, as they do in simulateTicks
+#define ARRIVAL 0 //a new portion of cars comes
+#define INFLOW 1 //cars come from another light (in a network)
+#define GREEN 2 //the red light switches to green and the first cars leave
+#define DEPARTURE 3 //the next cars leave while the green light is on
+#define RED 4 //the green light switches to red
+
+//the order of the priority queue: the event that is later is lower
+static bool later(const lightEvent& a, const lightEvent& b) {
+	if (a.time != b.time)
+		return a.time > b.time;
+	return a.kind > b.kind;
+}
+
+
+lightSimulation::lightSimulation(const lightSettings& s, streamRandom* r): keepDepartures(false), series(0), drainAll(false), settings(s), random(r), counted(0), greenEnds(0) {
+	stats.maxL = stats.maxT = stats.carCount = stats.allTime = stats.totLen = 0;
+
+	//at the begining some cars enter the queue
+	if (settings.perPerMinute == 0) {
+		int cars = random ? random->poisson(settings.arrival) : samplePoisson(settings.arrival);
+		q.enqueue(cars, 0);
+		stats.carCount += cars;
+	}
+	else {
+		schedule(0, ARRIVAL, 0);
+	}
+	schedule(settings.redInc, GREEN, 0);
+}
+
+void lightSimulation::schedule(long long time, int kind, int cars) {
+	lightEvent e;
+	e.time = time;
+	e.kind = kind;
+	e.cars = cars;
+	events.push_back(e);
+	push_heap(events.begin(), events.end(), later);
+}
+
+void lightSimulation::receive(long long time, int cars) {
+	schedule(time, INFLOW, cars);
+}
+
+//counts the length of the queue in the periods since the last counted one up to 'until', as the length doesn't change between events
+void lightSimulation::countLength(long long until) {
+	if (until > counted) {
+		stats.totLen += (long long)q.length * (until - counted);
+		stats.lengths.add(q.length, until - counted);
+		if (series)
+			series->add(counted, until, q.length);
+		if (q.length > stats.maxL)
+			stats.maxL = q.length;
+		counted = until;
+	}
+}
+
+void lightSimulation::depart(long long time) {
+	int cars = q.dequeue(settings.depCarsNum, time, stats.allTime, stats.maxT, stats.waits);
+	if (keepDepartures && cars > 0)
+		departures.push_back(make_pair(time, cars));
+}
+
+
+void lightSimulation::advance(long long until) {
+	if (until > settings.periods)
+		until = settings.periods;
+
+	while (!events.empty() && events.front().time < until) {
+		pop_heap(events.begin(), events.end(), later);
+		lightEvent e = events.back();
+		events.pop_back();
+
+		if (e.kind == ARRIVAL || e.kind == INFLOW) {
+			//the cars are counted in the length of the period they come in
+			countLength(e.time);
+			int cars = e.cars;
+			if (e.kind == ARRIVAL) {
+				cars = random ? random->poisson(settings.arrival) : samplePoisson(settings.arrival);
+				schedule(e.time + settings.perPerMinute, ARRIVAL, 0);
+			}
+			q.enqueue(cars, e.time);
+			stats.carCount += cars;
+			continue;
+		}
+
+		//and the cars that leave are counted in the length of the period they leave in
+		countLength(e.time + 1);
+		if (e.kind == GREEN) {
+			depart(e.time);
+			//the next cars go one period later than depPer after these, then every depPer
+			greenEnds = e.time + settings.greenInc;
+			if (e.time + settings.depPer + 1 < greenEnds)
+				schedule(e.time + settings.depPer + 1, DEPARTURE, 0);
+			schedule(greenEnds, RED, 0);
+		}
+		else if (e.kind == DEPARTURE) {
+			depart(e.time);
+			if (e.time + settings.depPer < greenEnds)
+				schedule(e.time + settings.depPer, DEPARTURE, 0);
+		}
+		else {
+			schedule(e.time + settings.redInc, GREEN, 0);
+		}
+	}
+}
+
+
+void lightSimulation::finish(lightStatistics& result) {
+	advance(settings.periods);
+	countLength(settings.periods);
+
+	//regarding the remains of the queue: simulateTicks counts them out while the queue gets shorter, so half of them leave
+	q.dequeue(drainAll ? q.length : (q.length + 1) / 2, settings.periods, stats.allTime, stats.maxT, stats.waits);
+	result = stats;
+}
+
+
+void simulateEvents(const lightSettings& settings, lightStatistics& stats, streamRandom* random, lengthSeries* series, bool drainAll) {
+	lightSimulation simulation(settings, random);
+	simulation.series = series;
+	simulation.drainAll = drainAll;
+	simulation.finish(stats);
+}
@@ -0,0 +1,57 @@
+//Measures.cpp : what is kept of the queue while the simulation goes besides the sums: the histograms of the waits and
+//lengths, for their quantiles, and the series of the length
+//Created by Anna Tigunova
+
+#include <math.h>
+#include "Traffic.h"
+using namespace std;
+
+
+long long hdrHistogram::quantile(double q) const {
+	if (total == 0)
+		return 0;
+	long long rank = (long long)ceil(q * total); //the number of values that are not above the quantile
+	if (rank < 1)
+		rank = 1;
+	long long seen = 0;
+	size_t bucket = 0;
+	for (; bucket + 1 < counts.size(); bucket++) {
+		seen += counts[bucket];
+		if (seen >= rank)
+			break;
+	}
+	//the largest value of the bucket
+	int shift = bucket < 128 ? 0 : (int)(bucket / 64) - 1;
+	long long top = (((long long)(bucket - shift * 64) + 1) << shift) - 1;
+	return top < largest ? top : largest;
+}
+
+void hdrHistogram::merge(const hdrHistogram& other) {
+	if (other.counts.size() > counts.size())
+		counts.resize(other.counts.size(), 0);
+	for (size_t i=0; i<other.counts.size(); i++)
+		counts[i] += other.counts[i];
+	total += other.total;
+	if (other.largest > largest)
+		largest = other.largest;
+}
+
+
+lengthSeries::lengthSeries(long long resolution): resolution(resolution > 0 ? resolution : 1), next(0), samples(0), last(0) {}
+
+static void putVarint(ostream& f, unsigned long long value) {
+	while (value >= 0x80) {
+		f.put((char)(value | 0x80));
+		value >>= 7;
+	}
+	f.put((char)value);
+}
+
+void lengthSeries::write(ostream& f, int increment) const {
+	f.write("TLQS", 4);
+	putVarint(f, increment);
+	putVarint(f, resolution);
+	putVarint(f, samples);
+	if (!bytes.empty())
+		f.write((const char*)&bytes[0], bytes.size());
+}
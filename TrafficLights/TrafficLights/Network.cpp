@@ -0,0 +1,229 @@
+//Network.cpp : the simulation of many traffic lights, where the cars that leave one light come to the queues of the
+//next ones along the roads, on several threads
+//Created by Anna Tigunova
+//
+//every thread has its own block of lights and they all go from one window of periods to the next together: a window is
+//as long as the shortest road, so the cars sent within it can't come anywhere before the next one, and the lights of a
+//thread are simulated through the whole window without waiting for the other threads (conservative synchronization
+//with the roads as the lookahead); between the windows the cars are handed over as mail
+
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Traffic.h"
+using namespace std;
+
+
+//reads 'count' pairs key-value in any order, case-insensitive
+static bool readPairs(ifstream& f, int count, map<string, int>& values) {
+	char key[100], value[100];
+	values.clear();
+	for (int j=0; j<count; j++) {
+		if (!(f >> key >> value))
+			return false;
+		toLower(key);
+		values[key] = atoi(value);
+	}
+	return true;
+}
+
+
+bool readNetwork(const char* name, lightNetwork& network) {
+	ifstream f(name, ios::in);
+	map<string, int> values;
+	if (!readPairs(f, 4, values))
+		return false;
+	int lights = values["intersections"];
+	int roads = values["roads"];
+	network.runtime = values["runtime"];
+	network.increment = values["increment"];
+	if (lights <= 0 || roads < 0 || network.runtime <= 0 || network.increment <= 0)
+		return false;
+
+	network.lights.resize(lights);
+	for (int i=0; i<lights; i++) {
+		if (!readPairs(f, 4, values) || values["departure"] <= 0)
+			return false;
+		makeSettings(network.lights[i], values["arrival"], values["departure"], network.runtime, network.increment, values["red"], values["green"]);
+	}
+
+	//the shares of the roads from a light are not more than all of its cars
+	vector<int> shares(lights, 0);
+	network.roads.resize(roads);
+	for (int i=0; i<roads; i++) {
+		if (!readPairs(f, 4, values))
+			return false;
+		networkRoad& r = network.roads[i];
+		r.from = values["from"] - 1;
+		r.to = values["to"] - 1;
+		r.travel = values["travel"];
+		r.share = values["share"];
+		if (r.from < 0 || r.from >= lights || r.to < 0 || r.to >= lights || r.travel < 0 || r.share < 0)
+			return false;
+		shares[r.from] += r.share;
+		if (shares[r.from] > 100)
+			return false;
+	}
+	return true;
+}
+
+
+//the cars that one light sends to another: they come to the light 'to' at the period 'time'
+struct carMail {
+	int to;
+	long long time;
+	int cars;
+};
+
+//the threads wait here until all of them finish the window
+class windowBarrier {
+public:
+	windowBarrier(int threads): threads(threads), waiting(0), generation(0) {}
+
+	void wait() {
+		unique_lock<mutex> lock(m);
+		long g = generation;
+		if (++waiting == threads) {
+			waiting = 0;
+			generation++;
+			allCame.notify_all();
+			return;
+		}
+		while (generation == g)
+			allCame.wait(lock);
+	}
+
+private:
+	mutex m;
+	condition_variable allCame;
+	int threads;
+	int waiting;
+	long generation; //the number of windows all the threads finished
+};
+
+
+//what the threads share; every light, its counters and its roads belong to one thread only
+struct networkRun {
+	long long periods;
+	long long window; //the number of periods in a window
+	int threads;
+	vector<int> firstLight; //the lights of thread t are from firstLight[t] to firstLight[t+1]
+	vector<int> owner; //the thread of every light
+	vector<lightSimulation> lights;
+	vector<vector<int> > roadsFrom; //the roads from every light
+	vector<long long> travel; //the periods every road takes
+	vector<long long> departed; //the cars that left every light
+	vector<long long> sent; //the cars that went along every road
+	vector<vector<carMail> > mail[2]; //mail[w % 2][from * threads + to]: what thread 'from' sent to thread 'to' in the window w
+};
+
+
+//sends the cars that left the light along its roads: every road gets its share of all the cars that left so far,
+//so the shares are kept without any randomness and don't depend on the threads
+static void route(const lightNetwork* network, networkRun* run, int light, vector<vector<carMail> >& box, int me) {
+	lightSimulation& l = run->lights[light];
+	const vector<int>& roads = run->roadsFrom[light];
+	for (size_t d=0; d<l.departures.size(); d++) {
+		run->departed[light] += l.departures[d].second;
+		for (size_t j=0; j<roads.size(); j++) {
+			int road = roads[j];
+			const networkRoad& r = network->roads[road];
+			long long should = run->departed[light] * r.share / 100;
+			carMail m;
+			m.to = r.to;
+			m.time = l.departures[d].first + run->travel[road];
+			m.cars = (int)(should - run->sent[road]);
+			run->sent[road] = should;
+			//the cars that come after the runtime are not simulated
+			if (m.cars > 0 && m.time < run->periods)
+				box[me * run->threads + run->owner[r.to]].push_back(m);
+		}
+	}
+	l.departures.clear();
+}
+
+static void simulateBlock(const lightNetwork* network, networkRun* run, windowBarrier* barrier, int me) {
+	int threads = run->threads;
+	long long w = 0;
+	for (long long start=0; start<run->periods; start+=run->window, w++) {
+		//the mail of the previous window comes now or later, as every road is at least a window long
+		vector<vector<carMail> >& inbox = run->mail[(w + 1) % 2];
+		for (int from=0; from<threads; from++) {
+			vector<carMail>& box = inbox[from * threads + me];
+			for (size_t j=0; j<box.size(); j++)
+				run->lights[box[j].to].receive(box[j].time, box[j].cars);
+			box.clear();
+		}
+
+		for (int i=run->firstLight[me]; i<run->firstLight[me + 1]; i++) {
+			run->lights[i].advance(start + run->window);
+			route(network, run, i, run->mail[w % 2], me);
+		}
+		barrier->wait();
+	}
+}
+
+
+void simulateNetwork(const lightNetwork& network, int threads, unsigned long long seed, vector<lightStatistics>& stats) {
+	int n = (int)network.lights.size();
+	if (threads > n)
+		threads = n;
+	if (threads < 1)
+		threads = 1;
+
+	networkRun run;
+	run.threads = threads;
+	run.periods = network.lights[0].periods;
+
+	//the streams are made before the lights, which keep pointers to them
+	vector<streamRandom> streams;
+	streams.reserve(n);
+	for (int i=0; i<n; i++)
+		streams.push_back(streamRandom(seed, i));
+	run.lights.reserve(n);
+	for (int i=0; i<n; i++) {
+		run.lights.push_back(lightSimulation(network.lights[i], &streams[i]));
+		run.lights[i].keepDepartures = true;
+		run.lights[i].drainAll = true;
+	}
+
+	//the window is as long as the shortest road, and the whole runtime if there are no roads
+	run.window = run.periods > 0 ? run.periods : 1;
+	run.roadsFrom.resize(n);
+	run.travel.resize(network.roads.size());
+	for (size_t j=0; j<network.roads.size(); j++) {
+		long long travel = (long long)network.roads[j].travel * 1000 / network.increment;
+		run.travel[j] = travel > 0 ? travel : 1; //a road shorter than a period takes one
+		if (run.travel[j] < run.window)
+			run.window = run.travel[j];
+		run.roadsFrom[network.roads[j].from].push_back((int)j);
+	}
+	run.departed.assign(n, 0);
+	run.sent.assign(network.roads.size(), 0);
+
+	//the lights are shared out in blocks one after another, so the neighbours in the file are mostly on the same thread
+	run.firstLight.resize(threads + 1);
+	run.owner.resize(n);
+	for (int t=0; t<=threads; t++)
+		run.firstLight[t] = (int)((long long)n * t / threads);
+	for (int t=0; t<threads; t++)
+		for (int i=run.firstLight[t]; i<run.firstLight[t + 1]; i++)
+			run.owner[i] = t;
+	run.mail[0].resize(threads * threads);
+	run.mail[1].resize(threads * threads);
+
+	windowBarrier barrier(threads);
+	vector<thread> workers;
+	for (int t=0; t<threads; t++)
+		workers.push_back(thread(simulateBlock, &network, &run, &barrier, t));
+	for (int t=0; t<threads; t++)
+		workers[t].join();
+
+	stats.resize(n);
+	for (int i=0; i<n; i++)
+		run.lights[i].finish(stats[i]);
+}
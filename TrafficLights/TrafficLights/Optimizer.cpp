@@ -0,0 +1,64 @@
+//Optimizer.cpp : the search for the light sequence with the least mean wait, first on a grid of red and green times,
+//then around the best point of it with the step halved until it is a second
+//Created by Anna Tigunova
+//
+//every sequence is simulated with the same streams (common random numbers): the cars come the same in replication r
+//whatever the lights are, so two sequences differ by the lights only and not by the luck of their arrivals, and much
+//fewer replications tell them apart
+
+#include <set>
+#include <utility>
+#include "Traffic.h"
+using namespace std;
+
+
+//the sequences simulated so far
+typedef set<pair<int, int> > triedLights;
+
+
+//simulates the sequence unless it was already, and takes it if it waits less than the best one
+static void tryLights(const lightSettings& settings, int red, int green, int minTime, int maxTime, int replications, int threads,
+	unsigned long long seed, triedLights& tried, timingResult& best) {
+	if (red < minTime || red > maxTime || green < minTime || green > maxTime || tried.count(make_pair(red, green)) != 0)
+		return;
+
+	lightSettings candidate = settings;
+	setLights(candidate, red, green);
+	replicationSummary summary;
+	simulateReplications(candidate, replications, threads, seed, summary);
+	tried.insert(make_pair(red, green));
+	best.tried++;
+
+	if (best.tried == 1 || summary.avgWait.mean < best.summary.avgWait.mean) {
+		best.red = red;
+		best.green = green;
+		best.summary = summary;
+	}
+}
+
+
+void optimizeLights(const lightSettings& settings, int minTime, int maxTime, int step, int replications, int threads, unsigned long long seed, timingResult& best) {
+	if (step < 1)
+		step = 1;
+	triedLights tried;
+	best.tried = 0;
+
+	for (int red=minTime; red<=maxTime; red+=step)
+		for (int green=minTime; green<=maxTime; green+=step)
+			tryLights(settings, red, green, minTime, maxTime, replications, threads, seed, tried, best);
+	if (best.tried == 0)
+		return;
+
+	//moving to the best neighbour while there is a better one, then looking closer
+	for (int s=step/2; s>=1; s/=2) {
+		int red, green;
+		do {
+			red = best.red;
+			green = best.green;
+			tryLights(settings, red - s, green, minTime, maxTime, replications, threads, seed, tried, best);
+			tryLights(settings, red + s, green, minTime, maxTime, replications, threads, seed, tried, best);
+			tryLights(settings, red, green - s, minTime, maxTime, replications, threads, seed, tried, best);
+			tryLights(settings, red, green + s, minTime, maxTime, replications, threads, seed, tried, best);
+		} while (best.red != red || best.green != green);
+	}
+}
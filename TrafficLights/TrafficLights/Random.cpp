@@ -0,0 +1,61 @@
+//Random.cpp : poisson distributed arrivals from a stream of streamRandom
+//Created by Anna Tigunova
+
+#include <math.h>
+#include "Traffic.h"
+
+
+//for a small mean the uniform numbers are multiplied until the product is below exp(-lambda), which takes lambda
+//of them on average; above it the transformed rejection with squeeze of Hormann (PTRS) takes a couple of them
+//whatever the mean is
+#define MULTIPLICATION_LIMIT 10
+
+
+//log(k!): a table for small k, Stirling's series above (lgamma is not used, it writes the sign into a global
+//variable that the threads of the replications would share)
+static double logFactorial(double k) {
+	static const double small[10] = {0, 0, 0.69314718055994531, 1.79175946922805500, 3.17805383034794562,
+		4.78749174278204599, 6.57925121201010100, 8.52516136106541430, 10.60460290274525023, 12.80182748008146961};
+	if (k < 10)
+		return small[(int)k];
+	double n = k + 1, r = 1 / (n * n);
+	return (n - 0.5) * log(n) - n + 0.91893853320467274 + (1.0/12 - r * (1.0/360 - r / 1260)) / n;
+}
+
+
+int streamRandom::poisson(double lambda) {
+	if (lambda <= 0)
+		return 0;
+
+	if (lambda < MULTIPLICATION_LIMIT) {
+		double zero_probability = exp(-lambda);
+		double product = uniform();
+		int count = 0;
+		while (product > zero_probability) {
+			count++;
+			product *= uniform();
+		}
+		return count;
+	}
+
+	double slam = sqrt(lambda);
+	double loglam = log(lambda);
+	double b = 0.931 + 2.53 * slam;
+	double a = -0.059 + 0.02483 * b;
+	double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+	double vr = 0.9277 - 3.6224 / (b - 2);
+
+	while (true) {
+		double u = uniform() - 0.5;
+		double v = uniform();
+		double us = 0.5 - fabs(u);
+		double k = floor((2 * a / us + b) * u + lambda + 0.43);
+		//most of the samples are taken in the box where the hat is surely under the distribution
+		if (us >= 0.07 && v <= vr)
+			return (int)k;
+		if (k < 0 || (us < 0.013 && v > us))
+			continue;
+		if (log(v) + log(invalpha) - log(a / (us * us) + b) <= -lambda + k * loglam - logFactorial(k))
+			return (int)k;
+	}
+}
@@ -0,0 +1,82 @@
+//Replications.cpp : independent runs of one simulation on several threads (Monte Carlo replications), summed up
+//into the means of the measures and their confidence intervals
+//Created by Anna Tigunova
+
+#include <math.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Traffic.h"
+using namespace std;
+
+
+//the measures of one replication, in cars and seconds
+struct replicationResult {
+	double avgLength, maxLength, avgWait, maxWait;
+};
+
+
+//the 97.5% quantiles of the Student distribution for 1 .. 30 degrees of freedom; above them the normal one is close enough
+static const double studentQuantile[31] = {0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056,
+	2.052, 2.048, 2.045, 2.042};
+
+static estimate summarize(const vector<double>& values) {
+	int n = (int)values.size();
+	estimate e;
+	e.mean = 0;
+	for (int i=0; i<n; i++)
+		e.mean += values[i];
+	e.mean /= n;
+	e.halfWidth = 0;
+	if (n > 1) {
+		double squares = 0;
+		for (int i=0; i<n; i++)
+			squares += (values[i] - e.mean) * (values[i] - e.mean);
+		double t = n-1 <= 30 ? studentQuantile[n-1] : 1.96;
+		e.halfWidth = t * sqrt(squares / (n-1) / n);
+	}
+	return e;
+}
+
+
+//a thread takes the next replication that nobody took until there are none
+static void replicate(const lightSettings* settings, unsigned long long seed, atomic<int>* next, vector<replicationResult>* results) {
+	int r;
+	while ((r = (*next)++) < (int)results->size()) {
+		streamRandom random(seed, r);
+		lightStatistics stats;
+		simulateEvents(*settings, stats, &random, 0, true);
+
+		replicationResult& result = (*results)[r];
+		result.avgLength = settings->periods > 0 ? (double)stats.totLen / settings->periods : 0;
+		result.maxLength = stats.maxL;
+		result.avgWait = stats.carCount > 0 ? (double)stats.allTime * settings->increment / 1000 / stats.carCount : 0;
+		result.maxWait = (double)stats.maxT * settings->increment / 1000;
+	}
+}
+
+
+void simulateReplications(const lightSettings& settings, int replications, int threads, unsigned long long seed, replicationSummary& summary) {
+	vector<replicationResult> results(replications);
+	atomic<int> next(0);
+	vector<thread> workers;
+	for (int i=0; i<threads; i++)
+		workers.push_back(thread(replicate, &settings, seed, &next, &results));
+	for (int i=0; i<threads; i++)
+		workers[i].join();
+
+	//every replication has its own stream, so the summary doesn't depend on the number of threads
+	vector<double> avgLength(replications), maxLength(replications), avgWait(replications), maxWait(replications);
+	for (int r=0; r<replications; r++) {
+		avgLength[r] = results[r].avgLength;
+		maxLength[r] = results[r].maxLength;
+		avgWait[r] = results[r].avgWait;
+		maxWait[r] = results[r].maxWait;
+	}
+	summary.replications = replications;
+	summary.avgLength = summarize(avgLength);
+	summary.maxLength = summarize(maxLength);
+	summary.avgWait = summarize(avgWait);
+	summary.maxWait = summarize(maxWait);
+}
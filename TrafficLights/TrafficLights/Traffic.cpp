@@ -3,8 +3,13 @@
 #include <time.h>
 #include <math.h>
 #include <fstream>
+#include <cstring>
+#include <iomanip>
 #include <map>
 #include <string>
+#include <thread>
+#include <vector>
+#include "Traffic.h"
 using namespace std;
 
 //Created by Anna Tigunova
@@ -24,7 +29,10 @@ using namespace std;
 10 many spaces in the input
 */
 
+#define OPTIMIZER_REPLICATIONS 100 //for every sequence the optimizer tries, unless -replications says otherwise
+
 static bool first_call = true; //for randomizer to give each time different values
+static bool seeded = false; //the option -seed gave the randomizer its seed, so the cars come the same every run
 
    
 //the function to give the amount of cars that come every minute using the poisson distribution
@@ -35,16 +43,14 @@ int samplePoisson(double lambda) {
 	/* Seed the random-number generator with current time so */
    /* that the numbers will be different every time we run */
 
-   if (first_call) {
+   if (first_call && !seeded) {
       srand( (unsigned)time( NULL ));
       first_call = false;
    }
 	int count;
 	double product;
 	double zero_probability;
-	/* Seed the random-number generator with current time so */
-	/* that the numbers will be different every time we run */
-	srand( (unsigned)time( NULL ) );
+	//the generator is seeded only once: seeding it with the time on every call gave the same cars for all the calls within a second
 	count = 0;
 	product = (double) rand() / (double) RAND_MAX;
 	zero_probability = exp(-lambda);
@@ -55,84 +61,301 @@ int samplePoisson(double lambda) {
 	return count;
 };
 
-//a class which model a car in the queue
-class node {
-	public:
-		node* next;
-		//stores the time the car entered the queue
-		int arrTime;
+//a function to make all symbols in the sting lowcase so as to make reading case-insensitive
+void toLower(char* str) {
+	while ((*str) != '\0') {
+		(*str) = tolower(*str);
+		str++;
+	}
+	return;
+}
+
 
-		//a constructor for node
-		node(int time): arrTime(time) {}
-};
 
+//the simulation period by period: the arrivals, the length of the queue and the lights are checked every period
+void simulateTicks(const lightSettings& settings, lightStatistics& stats, lengthSeries* series) {
+	long long periods = settings.periods;
+	int perPerMinute = settings.perPerMinute;
+	int depPer = settings.depPer;
+	int depCarsNum = settings.depCarsNum;
+	int redInc = settings.redInc;
+	int greenInc = settings.greenInc;
+	int currLight = 0; //0 - for red, 1 - for green
+	int countLight = 0; //how long the current light shone
+	int depCount = 0; //current number of periods since the last car departed
+
+	int maxL = 0; //max length
+	long long maxT = 0; // max time
+	long long carCount = 0; //all the cars that have entered the queue
+	long long allTime = 0; //the sum of the time that all cars spent in the queue
+	long long totLen = 0; //the sum of lengths of the queue for all the periods
+	hdrHistogram waits, lengths;
+
+	long long currDiff = 0; //time difference for currently dequeued car
+
+	long long k = 0; //periods iterator
+	queue q;
+
+	//at the begining some cars enter the queue
+	if (perPerMinute == 0) {
+		int cars = samplePoisson(settings.arrival);
+		q.enqueue(cars, k);
+		carCount += cars;
+	}
+
+	while (k < periods) {
 
-//a class for the queue of cars
-class queue {
-public:
-	node* head;
-	node* tail;
-	int length;
-
-//puts the 'count' amount of cars to the queue with the same time that they actually arrived 
-	void enqueue(int count, int time) {
-		for (int i=0; i<count; i++) {
-			if (length == 0) {
-			//if the queue is empty we make a new head
-				node* newNode = new node(time);
-				head = tail = newNode;
-				int a = 6;
+		//if a minute passed since last arrival a new portion of cars arrive
+		if (perPerMinute !=0 && k % perPerMinute == 0) {
+			int cars = samplePoisson(settings.arrival);
+			q.enqueue(cars, k);
+			carCount += cars;
+		}
+
+		//deals with avg and max length
+		totLen += q.length;
+		lengths.add(q.length, 1);
+		if (series)
+			series->add(k, k + 1, q.length);
+		if (q.length > maxL)
+			maxL = q.length;
+		//
+
+
+		// light check: what light is currently on
+		if (currLight == 0) //if red
+		{
+			//increase the time the current light shines
+			if (countLight < redInc) { //if it is still supposed to be shining
+				countLight++;
 			}
-			else {
-				// putting new value to the tail
-				node* newNode = new node(time);
-				tail->next = newNode;
-				tail = newNode;
+			else { //if it's time the light swithced
+				countLight = 0; //null the light timer
+				currLight = 1; //change the light
+				//so the green light turns on and cars leave the queue
+				for (int j=0; j<depCarsNum; j++) {
+					if (q.length != 0) {
+						currDiff = q.dequeue(k); //the first cars depart
+						allTime += currDiff;
+						waits.add(currDiff, 1);
+						if (currDiff > maxT)
+							maxT = currDiff;
+					}
+				}
+				depCount = -1;
 			}
-			length++;
 		}
-	}
-
 
-	//removes one car from the head of the queue, returns the difference between the time the car
-	//arrived and the depature time specified by 'time' parametr
-	int dequeue(int time) {
-		int timeDiff = time - head->arrTime;
-		//make sure the queue is not empty
-			if (length > 1) {
-				head = head->next;
-				length--;
+		//if green light is on
+		if (currLight == 1)
+		{
+			if (countLight < greenInc) {//if it still should shine
+				countLight++;
+				//cars leave the queue
+				if (depCount >= depPer){//we want to determine wether the previous car still leaves
+					for (int j=0; j<depCarsNum; j++) {//the next portion of cars leave (or one car)
+						if (q.length != 0) {
+							currDiff = q.dequeue(k); //dequeue the car
+							allTime += currDiff; //increase the whole time
+							waits.add(currDiff, 1);
+							if (currDiff > maxT)
+								maxT = currDiff;
+						}
+					}
+					depCount = 0;//the car has just left
+				}
+				depCount++; //increase the time since the car left queue counter
 			}
 			else {
-				//if there is only 1 car in the queue we empty it
-				if (length == 1) {
-					head = NULL;
-					tail = NULL;
-					length--;
-				}
+				//if we now should switch the light
+				countLight = 0;
+				currLight = 0;
+				depCount = 0;
+				countLight++; //as during the red light cars don't leave the queue
 			}
-		return timeDiff;
+		}
+		k++;
 	}
 
-	queue(): length(0) {};
-};
-
-//a function to make all symbols in the sting lowcase so as to make reading case-insensitive
-void toLower(char* str) {
-	while ((*str) != '\0') {
-		(*str) = tolower(*str);
-		str++;
+	//regarding the remains of the queue
+	if (q.length != 0) {
+		for (int k=0; k<q.length; k++) {
+			currDiff = q.dequeue(periods);
+			allTime += currDiff;
+			waits.add(currDiff, 1);
+			if (currDiff > maxT)
+				maxT = currDiff;
+		}
 	}
-	return;
+	//
+
+	stats.maxL = maxL;
+	stats.maxT = maxT;
+	stats.carCount = carCount;
+	stats.allTime = allTime;
+	stats.totLen = totLen;
+	stats.waits = waits;
+	stats.lengths = lengths;
+}
+
+
+void setLights(lightSettings& settings, int red, int green) {
+	settings.redInc = red * 1000 / settings.increment; //number of periods red light goes
+	settings.redInc =  settings.redInc > 0 ? settings.redInc : 1; //if the time the light goes is less than a period we assume that it goes for 1 period
+	settings.greenInc = green * 1000 / settings.increment; //number of periods green light goes
+	settings.greenInc =  settings.greenInc > 0 ? settings.greenInc : 1; //if the time the light goes is less than a period we assume that it goes for 1 period
+}
+
+
+void makeSettings(lightSettings& settings, int arrival, int departure, int runtime, int increment, int red, int green) {
+	settings.arrival = arrival;
+	settings.increment = increment;
+	settings.periods = (long long)runtime * 60 * 1000 / increment; //the number of periods during the runtime
+	settings.perPerMinute = 60 * 1000 / increment; //the number of periods in a minute
+	settings.depPer = departure * 1000 / increment; //how many periods it takes the car to leave the queue
+	settings.depCarsNum = increment / departure / 1000; //how many cars leave in one period
+	if (settings.depPer == 0) //if the car leaves sooner than the period finishes
+		settings.depPer = 1;
+	if (settings.depCarsNum == 0) //if a car leaves in more than 1 period
+		settings.depCarsNum = 1;
+	setLights(settings, red, green);
+}
+
+
+//a measure of the replications: the mean plus minus the half width of the confidence interval
+void printEstimate(ofstream& f2, const char* title, const estimate& e, const char* unit) {
+	f2 << title << fixed << setprecision(2) << e.mean << " +- " << e.halfWidth << unit << endl;
+	f2.unsetf(ios::fixed);
 }
 
 
+//the median and the 95th and 99th percentiles of the waits in seconds and of the lengths
+void printQuantiles(ofstream& f2, const lightStatistics& stats, int increment) {
+	const hdrHistogram& w = stats.waits;
+	const hdrHistogram& l = stats.lengths;
+	double seconds = increment / 1000.0; //of a period
+	f2 << "Wait quantiles: " << fixed << setprecision(2) << "p50 " << w.quantile(0.5) * seconds << "; p95 " << w.quantile(0.95) * seconds
+		<< "; p99 " << w.quantile(0.99) * seconds << " seconds" << endl;
+	f2.unsetf(ios::fixed);
+	f2 << "Length quantiles: p50 " << l.quantile(0.5) << "; p95 " << l.quantile(0.95) << "; p99 " << l.quantile(0.99) << " cars" << endl;
+}
+
+
+//simulates the network of the file and writes what every light and all of them found out, in cars and seconds
+int runNetwork(const char* name, int threads, unsigned long long seed) {
+	ofstream f2("output.txt", ios::out);
+	f2 << "Tigunova Anna" << endl;
+	lightNetwork network;
+	if (!readNetwork(name, network)) {
+		f2 << "Wrong network in " << name << endl;
+		return 1;
+	}
+	vector<lightStatistics> stats;
+	simulateNetwork(network, threads, seed, stats);
+
+	long long periods = network.lights[0].periods;
+	double seconds = network.increment / 1000.0; //of a period
+	f2 << "Network:        " << network.lights.size() << " intersections; " << network.roads.size() << " roads" << endl;
+	f2 << "Runime:         " << network.runtime << " minutes" << endl;
+	f2 << "Time increment: " << network.increment << " milliseconds" << endl;
+	f2 << endl << fixed << setprecision(2);
+
+	double cars = 0, allTime = 0, totLen = 0;
+	int maxL = 0;
+	long long maxT = 0;
+	lightStatistics all; //for the quantiles of all of them
+	for (size_t i=0; i<stats.size(); i++) {
+		const lightStatistics& s = stats[i];
+		f2 << "Intersection " << i + 1 << ":  " << s.carCount << " cars" << endl;
+		f2 << "Average length: " << (periods > 0 ? (double)s.totLen / periods : 0) << " cars" << endl;
+		f2 << "Maximum length: " << s.maxL << " cars" << endl;
+		f2 << "Average wait:   " << (s.carCount > 0 ? s.allTime * seconds / s.carCount : 0) << " seconds" << endl;
+		f2 << "Maximum wait:   " << s.maxT * seconds << " seconds" << endl;
+		printQuantiles(f2, s, network.increment);
+		f2 << fixed << setprecision(2) << endl;
+		cars += s.carCount;
+		allTime += s.allTime;
+		totLen += s.totLen;
+		maxL = s.maxL > maxL ? s.maxL : maxL;
+		maxT = s.maxT > maxT ? s.maxT : maxT;
+		all.waits.merge(s.waits);
+		all.lengths.merge(s.lengths);
+	}
 
+	//a car that goes through several lights is counted at every one of them
+	f2 << "All intersections: " << (long long)cars << " cars" << endl;
+	f2 << "Average length: " << (periods > 0 ? totLen / periods / stats.size() : 0) << " cars" << endl;
+	f2 << "Maximum length: " << maxL << " cars" << endl;
+	f2 << "Average wait:   " << (cars > 0 ? allTime * seconds / cars : 0) << " seconds" << endl;
+	f2 << "Maximum wait:   " << maxT * seconds << " seconds" << endl;
+	printQuantiles(f2, all, network.increment);
+	return 0;
+}
+
+
+//with the option -ticks the simulation goes period by period, as it used to, instead of from one event to the next
+//with the option -seed n the randomizer is seeded with n once, so that the same cars come in every run
+//with the option -replications r every simulation is run r times, each with its own stream of the seed (see
+//Replications.cpp), on the number of threads given by -threads, and the means of the measures are printed
+//with the option -optimize the red and green times of every simulation are searched for the least mean wait (see
+//Optimizer.cpp), between the times and with the step given by -grid min max step (seconds), and the best ones are printed
+//with the option -quantiles the median and the 95th and 99th percentiles of the wait and the length are printed as well
+//with the option -series file milliseconds the length of the queue of every simulation is written to the file every
+//so many milliseconds, in the binary format of lengthSeries::write, one simulation after another
+//with the option -network file the lights and roads of the file are simulated together instead of input.txt (see Network.cpp)
+int main(int argc, char* argv[]) {
+	bool ticks = false, optimize = false;
+	bool quantiles = false;
+	const char* network = 0;
+	const char* seriesName = 0;
+	int seriesTime = 1000;
+	int gridMin = 5, gridMax = 120, gridStep = 5;
+	int replications = 0;
+	int threads = thread::hardware_concurrency();
+	unsigned long long seed = (unsigned long long)time(NULL);
+	for (int i=1; i<argc; i++) {
+		if (strcmp(argv[i], "-ticks") == 0)
+			ticks = true;
+		else if (strcmp(argv[i], "-seed") == 0 && i+1 < argc) {
+			seed = strtoull(argv[++i], 0, 10);
+			srand((unsigned)seed);
+			seeded = true;
+		}
+		else if (strcmp(argv[i], "-replications") == 0 && i+1 < argc)
+			replications = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-threads") == 0 && i+1 < argc)
+			threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-optimize") == 0)
+			optimize = true;
+		else if (strcmp(argv[i], "-grid") == 0 && i+3 < argc) {
+			gridMin = atoi(argv[++i]);
+			gridMax = atoi(argv[++i]);
+			gridStep = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-network") == 0 && i+1 < argc)
+			network = argv[++i];
+		else if (strcmp(argv[i], "-quantiles") == 0)
+			quantiles = true;
+		else if (strcmp(argv[i], "-series") == 0 && i+2 < argc) {
+			seriesName = argv[++i];
+			seriesTime = atoi(argv[++i]);
+		}
+	}
+	if (threads < 1)
+		threads = 1;
+	if (gridMin < 1 || gridMin > gridMax || gridStep < 1) {
+		fprintf(stderr, "Error: -grid needs 1 <= min <= max and a step of at least 1, not %d %d %d\n", gridMin, gridMax, gridStep);
+		return 1;
+	}
+	if (network != 0)
+		return runNetwork(network, threads, seed);
 
-int main() {
 	//the files we read and write to
 	ifstream f("input.txt", ios::in);
 	ofstream f2("output.txt", ios::out);
+	ofstream fs;
+	if (seriesName != 0)
+		fs.open(seriesName, ios::out | ios::binary);
 
 	//number of experiments
 	int N = 0;
@@ -160,130 +383,61 @@ int main() {
 
 
 
-		//important values
-		long periods = inpVals["runtime"] * 60 * 1000 / inpVals["increment"]; //the number of periods during the runtime determined by increment value
-		int perPerMinute = 60 * 1000 / inpVals["increment"]; //the number of periods in a minute
-		int currLight = 0; //0 - for red, 1 - for green
-		int countLight = 0; //how long the current light shone
-		int depPer = inpVals["departure"] * 1000 / inpVals["increment"]; //how many periods it takes the car to leave the queue
-		int depCarsNum = inpVals["increment"] / inpVals["departure"] / 1000; //how many cars leave in one period
-		if (depPer == 0) //if the car leaves sooner than the period finishes
-			depPer = 1;
-		if (depCarsNum == 0) //if a car leaves in more than 1 period
-			depCarsNum = 1;
-		int depCount = 0; //current number of periods since the last car departed
-		int redInc = inpVals["red"] * 1000 / inpVals["increment"]; //number of periods red light goes
-		redInc =  redInc > 0 ? redInc : 1; //if the time the light goes is less than a period we assume that it goes for 1 period
-		int greenInc = inpVals["green"] * 1000 / inpVals["increment"]; //number of periods green light goes
-		greenInc =  greenInc > 0 ? greenInc : 1; //if the time the light goes is less than a period we assume that it goes for 1 period
-
-		int maxL = 0; //max length
-		int avgL = 0; //average length
-		int maxT = 0; // max time
-		int avgT = 0; //average time
-		int carCount = 0; //all the cars that have entered the queue
-		int allTime = 0; //the sum of the time that all cars spent in the queue
-		int totLen = 0; //the sum of lengths of the queue for all the periods
-		
-		int currDiff = 0; //time difference for currently dequeued car
-
-		long k = 0; //periods iterator
-		queue q;
-
-		//at the begining some cars enter the queue
-		if (perPerMinute == 0) {
-			int cars = samplePoisson(inpVals["arrival"]);
-			q.enqueue(cars, k);
-			carCount += cars;
-		}
-
-		while (k < periods) {
-
-			//if a minute passed since last arrival a new portion of cars arrive
-			if (perPerMinute !=0 && k % perPerMinute == 0) {
-				int cars = samplePoisson(inpVals["arrival"]);
-				q.enqueue(cars, k);
-				carCount += cars;
-			}
-
-			//deals with avg and max length
-			totLen += q.length;
-			if (q.length > maxL)
-				maxL = q.length;
-			//
-
+		//important values, counted in periods determined by increment value
+		lightSettings settings;
+		makeSettings(settings, inpVals["arrival"], inpVals["departure"], inpVals["runtime"], inpVals["increment"], inpVals["red"], inpVals["green"]);
+		long long periods = settings.periods;
 
-			// light check: what light is currently on
-			if (currLight == 0) //if red
-			{
-				//increase the time the current light shines
-				if (countLight < redInc) { //if it is still supposed to be shining
-					countLight++;
-				}
-				else { //if it's time the light swithced
-					countLight = 0; //null the light timer
-					currLight = 1; //change the light
-					//so the green light turns on and cars leave the queue
-					for (int j=0; j<depCarsNum; j++) {
-						if (q.length != 0) {
-							currDiff = q.dequeue(k); //the first cars depart
-							allTime += currDiff;
-							if (currDiff > maxT)
-								maxT = currDiff;
-						}
-					}
-					depCount = -1;
-				}
-			}
+		//output
+		f2 << "Arrival rate:   " << inpVals["arrival"]  << " cars per minute" << endl;
+		f2 << "Departure:      " << inpVals["departure"]  << " seconds per car" << endl;
+		f2 << "Runime:         " << inpVals["runtime"] << " minutes" << endl;
+		f2 << "Time increment: " << inpVals["increment"] << " milliseconds" << endl;
+		f2 << "Light sequence: Red " << inpVals["red"] << " seconds; Green " << inpVals["green"] << " seconds" <<  endl;
 
-			//if green light is on
-			if (currLight == 1)
-			{
-				if (countLight < greenInc) {//if it still should shine
-					countLight++;
-					//cars leave the queue
-					if (depCount >= depPer){//we want to determine wether the previous car still leaves
-						for (int j=0; j<depCarsNum; j++) {//the next portion of cars leave (or one car)
-							if (q.length != 0) {
-								currDiff = q.dequeue(k); //dequeue the car
-								allTime += currDiff; //increase the whole time
-								if (currDiff > maxT)
-									maxT = currDiff;
-							}
-						}
-						depCount = 0;//the car has just left
-					}
-					depCount++; //increase the time since the car left queue counter
-				}
-				else {
-					//if we now should switch the light
-					countLight = 0;
-					currLight = 0;
-					depCount = 0;
-					countLight++; //as during the red light cars don't leave the queue
-				}
+		if (optimize) {
+			timingResult best;
+			optimizeLights(settings, gridMin, gridMax, gridStep, replications > 0 ? replications : OPTIMIZER_REPLICATIONS, threads, seed, best);
+			if (best.tried == 0) {
+				f2 << "Best sequence:  no sequence tried" << endl << endl;
+				continue;
 			}
-			k++;
+			f2 << "Best sequence:  Red " << best.red << " seconds; Green " << best.green << " seconds (of " << best.tried << " tried)" << endl;
+			f2 << "Replications:   " << best.summary.replications << " (means with 95% confidence intervals)" << endl;
+			printEstimate(f2, "Average length: ", best.summary.avgLength, " cars");
+			printEstimate(f2, "Maximum length: ", best.summary.maxLength, " cars");
+			printEstimate(f2, "Average wait:   ", best.summary.avgWait, " seconds");
+			printEstimate(f2, "Maximum wait:   ", best.summary.maxWait, " seconds");
+			f2 << endl;
+			continue;
 		}
 
-		//regarding the remains of the queue
-		if (q.length != 0) {
-			for (int k=0; k<q.length; k++) {
-				currDiff = q.dequeue(periods);
-				allTime += currDiff;
-				if (currDiff > maxT)
-					maxT = currDiff;
-			}
+		if (replications > 0) {
+			replicationSummary summary;
+			simulateReplications(settings, replications, threads, seed, summary);
+			f2 << "Replications:   " << summary.replications << " (means with 95% confidence intervals)" << endl;
+			printEstimate(f2, "Average length: ", summary.avgLength, " cars");
+			printEstimate(f2, "Maximum length: ", summary.maxLength, " cars");
+			printEstimate(f2, "Average wait:   ", summary.avgWait, " seconds");
+			printEstimate(f2, "Maximum wait:   ", summary.maxWait, " seconds");
+			f2 << endl;
+			continue;
 		}
-		//
 
+		lightStatistics stats;
+		lengthSeries series(seriesTime / settings.increment);
+		if (ticks)
+			simulateTicks(settings, stats, seriesName ? &series : 0);
+		else
+			simulateEvents(settings, stats, 0, seriesName ? &series : 0);
+		if (seriesName != 0)
+			series.write(fs, settings.increment);
+		int maxL = stats.maxL;
+		long long maxT = stats.maxT;
+		long long carCount = stats.carCount;
+		long long allTime = stats.allTime;
+		long long totLen = stats.totLen;
 
-		//output
-		f2 << "Arrival rate:   " << inpVals["arrival"]  << " cars per minute" << endl;
-		f2 << "Departure:      " << inpVals["departure"]  << " seconds per car" << endl;
-		f2 << "Runime:         " << inpVals["runtime"] << " minutes" << endl;
-		f2 << "Time increment: " << inpVals["increment"] << " milliseconds" << endl;
-		f2 << "Light sequence: Red " << inpVals["red"] << " seconds; Green " << inpVals["green"] << " seconds" <<  endl;
 		if (totLen/periods != 0)
 			f2 << "Average length: " << totLen/periods << " cars" << endl;
 		else
@@ -299,6 +453,8 @@ int main() {
 			f2 << "Average wait:   " << allTime*inpVals["increment"]/1000/carCount << " seconds" << endl;
 			f2 << "Maximum wait:   " << maxT*inpVals["increment"]/1000 << " seconds" << endl;
 		}
+		if (quantiles)
+			printQuantiles(f2, stats, settings.increment);
 		f2 << endl;
 
 		
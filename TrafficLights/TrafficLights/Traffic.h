@@ -0,0 +1,344 @@
+//Traffic.h : the queue of cars and the simulation of the traffic light, shared by the ways to run it
+//Created by Anna Tigunova
+
+#pragma once
+
+#include <cstdio>
+#include <stdlib.h>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+
+//a histogram of the values of a measure (HDR): below 128 every value has its own bucket, above it every power of two is
+//split into 64 buckets, so a quantile is found within 1/64 of it however many values there are, and the buckets are
+//only as many as the largest value needs
+class hdrHistogram {
+public:
+	hdrHistogram(): total(0), largest(0) {}
+
+	//adds the value 'count' times
+	void add(long long value, long long count) {
+		if (count <= 0)
+			return;
+		int shift = 0;
+		while ((value >> shift) >= 128)
+			shift++;
+		size_t bucket = shift * 64 + (size_t)(value >> shift);
+		if (bucket >= counts.size())
+			counts.resize(bucket + 1, 0);
+		counts[bucket] += count;
+		total += count;
+		if (value > largest)
+			largest = value;
+	}
+
+	//the least value that the part 'q' of the values are not above, up to the precision of the buckets (Measures.cpp)
+	long long quantile(double q) const;
+
+	//adds all the values of the other histogram
+	void merge(const hdrHistogram& other);
+
+	long long total; //the number of values
+
+private:
+	std::vector<long long> counts;
+	long long largest; //the largest value, so that the quantiles are not above it
+};
+
+
+//the cars that came in the same period: they are in the queue one after another and wait the same
+struct carRun {
+	long long arrTime; //the period the cars entered the queue
+	int count;
+};
+
+
+//a class for the queue of cars, kept as runs of cars that came together in a ring buffer, so that a portion of
+//cars is put in at once and the memory is as much as the number of portions waiting, not of the cars
+class queue {
+public:
+	int length; //the number of cars
+
+//puts the 'count' amount of cars to the queue with the same time that they actually arrived
+	void enqueue(int count, long long time) {
+		if (count <= 0)
+			return;
+		if (runs > 0 && buffer[(first + runs - 1) & mask].arrTime == time) {
+			//they join the cars that came at the same time
+			buffer[(first + runs - 1) & mask].count += count;
+		}
+		else {
+			if (runs == (int)buffer.size())
+				grow();
+			carRun& r = buffer[(first + runs) & mask];
+			r.arrTime = time;
+			r.count = count;
+			runs++;
+		}
+		length += count;
+	}
+
+
+	//removes one car from the head of the queue, returns the difference between the time the car
+	//arrived and the depature time specified by 'time' parametr
+	long long dequeue(long long time) {
+		long long timeDiff = time - buffer[first].arrTime;
+		take(1);
+		return timeDiff;
+	}
+
+	//removes up to 'count' cars from the head of the queue at 'time', adding their waits to 'allTime' and 'waits' and the
+	//longest of them to 'maxT' without going through the cars one by one; returns the number of cars removed
+	int dequeue(int count, long long time, long long& allTime, long long& maxT, hdrHistogram& waits) {
+		if (count > length)
+			count = length;
+		if (count > 0 && time - buffer[first].arrTime > maxT)
+			maxT = time - buffer[first].arrTime; //the first car waited the longest
+		int left = count;
+		while (left > 0) {
+			carRun& r = buffer[first];
+			int cars = left < r.count ? left : r.count;
+			allTime += (long long)(time - r.arrTime) * cars;
+			waits.add(time - r.arrTime, cars);
+			take(cars);
+			left -= cars;
+		}
+		return count;
+	}
+
+	queue(): length(0), buffer(16), first(0), runs(0), mask(15) {};
+
+private:
+	//the cars leave the first run
+	void take(int cars) {
+		buffer[first].count -= cars;
+		length -= cars;
+		if (buffer[first].count == 0) {
+			first = (first + 1) & mask;
+			runs--;
+		}
+	}
+
+	//twice as much room, with the runs from the beginning of it
+	void grow() {
+		std::vector<carRun> bigger(buffer.size() * 2);
+		for (int i=0; i<runs; i++)
+			bigger[i] = buffer[(first + i) & mask];
+		buffer.swap(bigger);
+		first = 0;
+		mask = (int)buffer.size() - 1;
+	}
+
+	std::vector<carRun> buffer; //the size is a power of two
+	int first; //the run at the head
+	int runs; //the number of runs
+	int mask;
+};
+
+
+//the values of one simulation, counted in periods (the time increment)
+struct lightSettings {
+	int arrival; //cars per minute
+	int increment; //the length of a period in milliseconds
+	long long periods; //the number of periods during the runtime
+	int perPerMinute; //the number of periods in a minute
+	int depPer; //how many periods it takes the car to leave the queue
+	int depCarsNum; //how many cars leave in one period
+	int redInc; //number of periods red light goes
+	int greenInc; //number of periods green light goes
+};
+
+//sets the periods of the lights from their times in seconds
+void setLights(lightSettings& settings, int red, int green);
+
+//sets all the values from the input ones: cars per minute, seconds per car, minutes, milliseconds and the light times in seconds
+void makeSettings(lightSettings& settings, int arrival, int departure, int runtime, int increment, int red, int green);
+
+//a function to make all symbols in the sting lowcase so as to make reading case-insensitive
+void toLower(char* str);
+
+//what is found out by a simulation
+struct lightStatistics {
+	int maxL; //max length
+	long long maxT; // max time
+	long long carCount; //all the cars that have entered the queue
+	long long allTime; //the sum of the time that all cars spent in the queue
+	long long totLen; //the sum of lengths of the queue for all the periods
+	hdrHistogram waits; //the time of every car in the queue
+	hdrHistogram lengths; //the length of the queue in every period
+};
+
+
+//the length of the queue every 'resolution' periods, from the period 0: every sample is kept as the difference from the
+//previous one in a zigzag varint, so the series takes about a byte a sample while the queue changes slowly (Measures.cpp)
+class lengthSeries {
+public:
+	lengthSeries(long long resolution);
+
+	//the queue was 'length' long in the periods from 'from' up to 'until'
+	void add(long long from, long long until, int length) {
+		while (next < until) {
+			if (next >= from) {
+				put(zigzag((long long)length - last));
+				last = length;
+				samples++;
+			}
+			next += resolution;
+		}
+	}
+
+	//writes "TLQS", then the increment (milliseconds), the resolution (periods) and the number of samples as varints, then the samples
+	void write(std::ostream& f, int increment) const;
+
+private:
+	static unsigned long long zigzag(long long value) {
+		return value < 0 ? ((unsigned long long)(-(value + 1)) << 1) | 1 : (unsigned long long)value << 1;
+	}
+	void put(unsigned long long value) {
+		while (value >= 0x80) {
+			bytes.push_back((unsigned char)(value | 0x80));
+			value >>= 7;
+		}
+		bytes.push_back((unsigned char)value);
+	}
+
+	long long resolution;
+	long long next; //the period of the next sample
+	long long samples;
+	int last; //the previous sample
+	std::vector<unsigned char> bytes;
+};
+
+
+//a counter-based random generator: the n-th number of a stream is a hash of the seed, the stream and n, so every
+//replication has its own stream that doesn't depend on which thread runs it or what the others drew (Random.cpp)
+class streamRandom {
+public:
+	streamRandom(unsigned long long seed, unsigned long long stream): key(mix(seed * 0x9E3779B97F4A7C15ULL + mix(stream))), counter(0) {}
+
+	//a number in (0, 1)
+	double uniform() {
+		unsigned long long x = mix(key + (counter++) * 0x9E3779B97F4A7C15ULL);
+		return ((x >> 11) + 0.5) / 9007199254740992.0;
+	}
+
+	//the amount of cars that come in a minute, poisson distributed with the mean lambda
+	int poisson(double lambda);
+
+private:
+	//the finalizer of splitmix64
+	static unsigned long long mix(unsigned long long z) {
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	unsigned long long key;
+	unsigned long long counter;
+};
+
+
+//the amount of cars that come in a minute
+int samplePoisson(double lambda);
+
+//the simulation period by period; the length of the queue is put to the series if there is one
+void simulateTicks(const lightSettings& settings, lightStatistics& stats, lengthSeries* series = 0);
+
+//the same simulation from one event to the next (Events.cpp); with the same cars arriving it finds out the same
+//the cars come from the stream if there is one, otherwise from samplePoisson; drainAll is lightSimulation::drainAll
+void simulateEvents(const lightSettings& settings, lightStatistics& stats, streamRandom* random = 0, lengthSeries* series = 0, bool drainAll = false);
+
+struct lightEvent {
+	long long time; //the period it happens in
+	int kind;
+	int cars; //the cars that come from another light
+};
+
+//the simulation of simulateEvents, which can be stopped at any period and given cars from other lights (Events.cpp)
+class lightSimulation {
+public:
+	lightSimulation(const lightSettings& settings, streamRandom* random);
+
+	//the cars come to the queue at the period, which is not before the one the simulation was advanced to
+	void receive(long long time, int cars);
+
+	//goes through the events before the period 'until'
+	void advance(long long until);
+
+	//goes to the end of the runtime and lets the rest of the queue go
+	void finish(lightStatistics& result);
+
+	//if it is set, the cars that leave are kept in departures as (period, cars)
+	bool keepDepartures;
+	std::vector<std::pair<long long, int> > departures;
+
+	//if it is set, the length of the queue is put to it
+	lengthSeries* series;
+
+	//if it is set, finish lets all the cars left in the queue go, so that every car is in the waits; otherwise only
+	//half of them go, as in simulateTicks
+	bool drainAll;
+
+private:
+	void schedule(long long time, int kind, int cars);
+	void countLength(long long until);
+	void depart(long long time);
+
+	lightSettings settings;
+	streamRandom* random;
+	queue q;
+	std::vector<lightEvent> events; //a heap, the next event on the top
+	long long counted; //the lengths of the periods before it are counted
+	long long greenEnds; //the period the current green light switches to red
+	lightStatistics stats;
+};
+
+//the mean of a measure over the replications and the half width of its 95% confidence interval
+struct estimate {
+	double mean;
+	double halfWidth;
+};
+
+//what the replications of a simulation found out, in cars and seconds
+struct replicationSummary {
+	int replications;
+	estimate avgLength, maxLength, avgWait, maxWait;
+};
+
+//runs the simulation 'replications' times on 'threads' threads, replication r with the stream r of the seed (Replications.cpp)
+void simulateReplications(const lightSettings& settings, int replications, int threads, unsigned long long seed, replicationSummary& summary);
+
+//the light sequence with the least mean wait and what its replications found out
+struct timingResult {
+	int red, green; //seconds
+	int tried; //the number of sequences simulated
+	replicationSummary summary;
+};
+
+//searches the red and green times between minTime and maxTime seconds on a grid with the step, then around the best
+//point of it with smaller steps; every sequence is simulated with the same streams of the seed (Optimizer.cpp)
+void optimizeLights(const lightSettings& settings, int minTime, int maxTime, int step, int replications, int threads, unsigned long long seed, timingResult& best);
+
+//a road from one light to another: of the cars that leave 'from', 'share' percent go to 'to' and come there 'travel' seconds later
+struct networkRoad {
+	int from, to; //the numbers of the lights, from 0
+	int travel;
+	int share;
+};
+
+//the lights and the roads between them; the cars that none of the roads take leave the network
+struct lightNetwork {
+	int runtime; //minutes
+	int increment; //milliseconds
+	std::vector<lightSettings> lights;
+	std::vector<networkRoad> roads;
+};
+
+//reads the network from the file, returns false if it is not right (Network.cpp)
+bool readNetwork(const char* name, lightNetwork& network);
+
+//simulates the network on 'threads' threads, light i with the stream i of the seed; the lights are shared out between the
+//threads, which go together from one window of periods to the next, as long as the shortest road, so that the cars sent
+//in a window come in the next one or later and nobody waits for them within it (Network.cpp)
+void simulateNetwork(const lightNetwork& network, int threads, unsigned long long seed, std::vector<lightStatistics>& stats);
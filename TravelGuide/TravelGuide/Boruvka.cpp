@@ -0,0 +1,125 @@
+#include "Guide.h"
+#include <atomic>
+#include <cstdint>
+using namespace std;
+
+
+//Boruvka: in every round each tree of the forest takes the widest road that leaves it, which at least halves
+//the number of trees, so there are O(log V) rounds of O(E/threads) work. The roads are ordered by width and
+//then by their number, the same order as the stable sort of Kruskal, so both give exactly the same forest.
+//The trees are kept in a union-find without locks: a tree only ever changes its parent from itself to a tree
+//with a smaller number, with compare and swap, and the paths are halved with compare and swap as well.
+
+//the smaller the key the wider the road
+static uint64_t roadKey(const edge& e, int number) {
+	return ((uint64_t)((long long)INT_MAX - e.w) << 32) | (uint32_t)number;
+}
+
+static int findTree(vector<atomic<int> >& parent, int v) {
+	int p = parent[v].load(memory_order_relaxed);
+	while (p != v) {
+		int grand = parent[p].load(memory_order_relaxed);
+		if (grand != p)
+			parent[v].compare_exchange_weak(p, grand, memory_order_relaxed); //path halving, it may fail harmlessly
+		v = p;
+		p = parent[v].load(memory_order_relaxed);
+	}
+	return v;
+}
+
+//joins the trees of a and b; the roads chosen in one round never close a loop, so this always succeeds
+static void joinTrees(vector<atomic<int> >& parent, int a, int b) {
+	while (true) {
+		a = findTree(parent, a);
+		b = findTree(parent, b);
+		if (a == b)
+			return;
+		if (a < b)
+			swap(a, b);
+		int expected = a;
+		if (parent[a].compare_exchange_strong(expected, b, memory_order_relaxed))
+			return;
+	}
+}
+
+void maximumForest(int cityCount, const vector<edge>& edges, int threads, vector<edge>& forest) {
+	int roadCount = (int)edges.size();
+	vector<atomic<int> > parent(cityCount);
+	vector<atomic<uint64_t> > best(cityCount); //the key of the widest road leaving each tree
+	vector<atomic<char> > taken(roadCount); //the road is in the forest
+	vector<int> alive(roadCount), next(roadCount); //numbers of the roads between two different trees
+	int aliveCount = roadCount;
+
+	#pragma omp parallel for num_threads(threads)
+	for (int v=0; v<cityCount; v++)
+		parent[v].store(v, memory_order_relaxed);
+	#pragma omp parallel for num_threads(threads)
+	for (int i=0; i<roadCount; i++)
+		alive[i] = i;
+
+	while (aliveCount > 0) {
+		#pragma omp parallel for num_threads(threads)
+		for (int v=0; v<cityCount; v++)
+			best[v].store(UINT64_MAX, memory_order_relaxed);
+
+		//the widest road of every tree
+		#pragma omp parallel for num_threads(threads) schedule(static)
+		for (int i=0; i<aliveCount; i++) {
+			const edge& e = edges[alive[i]];
+			int a = findTree(parent, e.v1);
+			int b = findTree(parent, e.v2);
+			if (a == b)
+				continue;
+			uint64_t key = roadKey(e, alive[i]);
+			for (int side=0; side<2; side++) {
+				atomic<uint64_t>& slot = best[side == 0 ? a : b];
+				uint64_t current = slot.load(memory_order_relaxed);
+				while (key < current && !slot.compare_exchange_weak(current, key, memory_order_relaxed))
+					;
+			}
+		}
+
+		//join every tree with the one its widest road leads to; two trees may choose the same road
+		#pragma omp parallel for num_threads(threads) schedule(static)
+		for (int v=0; v<cityCount; v++) {
+			uint64_t key = best[v].load(memory_order_relaxed);
+			if (key == UINT64_MAX)
+				continue;
+			int number = (int)(uint32_t)key;
+			if (taken[number].exchange(1, memory_order_relaxed))
+				continue;
+			joinTrees(parent, edges[number].v1, edges[number].v2);
+		}
+
+		//keep only the roads that still join two trees: every thread compacts its own part,
+		//then the parts are moved together in order
+		int parts = threads;
+		vector<int> kept(parts + 1, 0); //kept[t+1] roads of part t, then the prefix sums
+		#pragma omp parallel for num_threads(threads) schedule(static, 1)
+		for (int t=0; t<parts; t++) {
+			int from = (int)((long long)aliveCount * t / parts);
+			int to = (int)((long long)aliveCount * (t+1) / parts);
+			int count = 0;
+			for (int i=from; i<to; i++) {
+				const edge& e = edges[alive[i]];
+				if (!taken[alive[i]].load(memory_order_relaxed) && findTree(parent, e.v1) != findTree(parent, e.v2))
+					next[from + count++] = alive[i];
+			}
+			kept[t+1] = count;
+		}
+		for (int t=0; t<parts; t++)
+			kept[t+1] += kept[t];
+		#pragma omp parallel for num_threads(threads) schedule(static, 1)
+		for (int t=0; t<parts; t++) {
+			int from = (int)((long long)aliveCount * t / parts);
+			for (int i=kept[t]; i<kept[t+1]; i++)
+				alive[i] = next[from + i - kept[t]];
+		}
+		aliveCount = kept[parts];
+	}
+
+	forest.clear();
+	for (int i=0; i<roadCount; i++)
+		if (taken[i].load(memory_order_relaxed))
+			forest.push_back(edges[i]);
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <climits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+
+//a structure which represents the edge of the graph - two vertexes and the number of passengers it can hold
+struct edge {
+	int v1, v2, w;
+	edge(int a, int b,int c): v1(a), v2(b), w(c) {};
+	edge() {};
+};
+
+
+//the road network in compressed sparse row form: the roads of town v are to[first[v]] .. to[first[v+1]-1]
+//and w holds how many passengers each of them can take; O(V+E) memory in three flat arrays
+struct graph {
+	int cityCount;
+	std::vector<int> first;
+	std::vector<int> to;
+	std::vector<int> w;
+
+	//builds the graph of a scenario from its roads (every road goes both ways)
+	//the arrays of the previous scenario are reused so only a larger scenario allocates
+	void build(int cityCount, const std::vector<edge>& edges);
+};
+
+
+//working memory of the searches, kept between scenarios so that they don't go to the allocator again
+struct arena {
+	std::vector<int> width; //capacity of the best route found so far to each town
+	std::vector<int> precedor; //the town before it on that route
+	std::vector<char> done;
+	std::vector<std::pair<int, int> > heap; //(capacity, town), a binary heap with the widest on the top
+
+	void reset(int cityCount);
+};
+
+
+//the answer for one pair of towns: the route with the largest capacity and that capacity
+//(the smallest number of passengers a road on the route can hold)
+struct route {
+	int capacity; //0 if the destination can't be reached
+	std::vector<int> towns; //from the source to the destination
+};
+
+
+//finds the route from source to destin whose narrowest road is as wide as possible
+//(modified Dijkstra: the label of a town is the capacity of the best route to it, not the length)
+//O(E log V) with a binary heap
+void widestPath(const graph& g, int source, int destin, arena& a, route& result);
+
+//the number of trips the guide needs to bring all the tourists along the route
+int tripCount(int tourists, int capacity);
+
+
+//the maximum spanning forest found with Boruvka on several threads (see Boruvka.cpp), O(E log V / threads);
+//of equally wide roads the one given first is preferred, so it is the same forest Kruskal finds
+void maximumForest(int cityCount, const std::vector<edge>& edges, int threads, std::vector<edge>& forest);
+
+
+//an index for many queries on the same road network: the maximum spanning forest holds a widest route between
+//any two towns, so it is built once (Kruskal, O(E log E)) and the narrowest road between two towns is found with
+//binary lifting to their lowest common ancestor in O(log V); listing the route costs its length
+class spanningIndex {
+public:
+	//with more than one thread the forest is found with the parallel Boruvka of maximumForest
+	void build(int cityCount, const std::vector<edge>& edges, int threads = 1);
+
+	void query(int source, int destin, route& result) const;
+
+private:
+	int find(int v);
+
+	int cityCount;
+	int levels; //number of ancestor levels, 2^levels > the depth of any tree
+	std::vector<int> parent; //union-find for Kruskal
+	std::vector<edge> sorted; //the roads from the widest to the narrowest
+	std::vector<edge> forest; //the roads of the maximum spanning forest
+	graph tree; //the forest as a graph, to root it
+	std::vector<int> depth; //number of roads to the root of the tree
+	std::vector<int> root; //the root of the tree of each town
+	std::vector<int> up; //up[k*cityCount+v] is the ancestor 2^k roads above v (the root if there are fewer)
+	std::vector<int> low; //low[k*cityCount+v] is the narrowest road between v and that ancestor
+};
+
+
+//the maximum spanning forest kept up to date while roads are added, removed or change their capacity,
+//so that queries can be mixed with the changes. The forest is stored in a link-cut tree in which every road of
+//the forest is a node between its two towns, so the narrowest road between two towns is a path aggregate:
+//- adding a road or widening one costs O(log V) amortized: if it closes a loop it replaces the narrowest road
+//  of the loop when it is wider
+//- removing (or narrowing) a road that is not in the forest costs O(log E)
+//- removing (or narrowing) a road of the forest splits its tree in two; the widest road outside the forest that
+//  joins them again is looked for among the roads of the towns of the smaller half only, so it costs the size of
+//  the smaller half and its roads (times log E), not polylogarithmic like the other changes
+//- a query costs O(log V) amortized plus the length of the route
+class dynamicIndex {
+public:
+	void reset(int cityCount);
+
+	//adds the road between a and b or changes its capacity (there is at most one road between two towns)
+	void setRoad(int a, int b, int w);
+
+	void removeRoad(int a, int b);
+
+	void query(int source, int destin, route& result);
+
+private:
+	struct node {
+		int child[2], parent;
+		bool flip; //the children of the whole subtree have to be swapped
+		int value; //the capacity of a road, INT_MAX for a town
+		int lowest; //the node with the smallest value in the splay subtree
+	};
+	struct road {
+		int a, b, w;
+		bool inForest;
+	};
+
+	bool isRoot(int x) const;
+	void push(int x);
+	void update(int x);
+	void rotate(int x);
+	void splay(int x);
+	void access(int x);
+	void makeRoot(int x);
+	int findRoot(int x);
+	bool connected(int x, int y);
+	void link(int x, int y);
+	void cut(int x, int y);
+
+	void insert(int id);
+	void linkRoad(int id);
+	void cutRoad(int id);
+	void addSpare(int id);
+	void dropSpare(int id);
+	int replacement(int a, int b);
+
+	int cityCount;
+	std::vector<node> nodes; //the towns, then one node for every road
+	std::vector<road> roads; //roads[id] is the road of node cityCount+id
+	std::vector<int> freeIds; //ids of removed roads, to be reused
+	std::map<std::pair<int, int>, int> byTowns; //the id of the road between two towns, the smaller town first
+	std::vector<std::set<int> > forestAt; //the ids of the roads of the forest at every town
+	std::vector<std::set<int> > spareAt; //the ids of the roads at every town that are not in the forest
+	std::vector<int> seen; //the town was reached by the search of a half of a tree if it holds its stamp
+	int stamp;
+	std::vector<int> half[2]; //the towns of the two halves reached so far
+	std::vector<int> stack;
+};
+
+
+//the binary road file: a header and then s, d, t of every road as 32-bit integers, exactly the numbers of a
+//scenario of input.txt, so that large networks are read without parsing text (the roads in one read)
+struct roadFileHeader {
+	char magic[4]; //"TGR1"
+	int cityCount, roadCount;
+	int source, destin, tourists;
+};
+
+//reads the scenario of a binary road file; the towns are numbered from 0 and the seat of the guide is taken
+//off every road, as when input.txt is read; false if the file can't be read, is not a road file or has a town
+//that is not one of its towns
+bool readRoadFile(const char* name, int& cityCount, std::vector<edge>& edges, int& source, int& destin, int& tourists);
@@ -0,0 +1,331 @@
+#include "Guide.h"
+#include <algorithm>
+using namespace std;
+
+
+//link-cut tree
+//-------------
+
+bool dynamicIndex::isRoot(int x) const {
+	int p = nodes[x].parent;
+	return p == -1 || (nodes[p].child[0] != x && nodes[p].child[1] != x);
+}
+
+void dynamicIndex::push(int x) {
+	node& n = nodes[x];
+	if (n.flip) {
+		swap(n.child[0], n.child[1]);
+		for (int d=0; d<2; d++)
+			if (n.child[d] != -1)
+				nodes[n.child[d]].flip = !nodes[n.child[d]].flip;
+		n.flip = false;
+	}
+}
+
+void dynamicIndex::update(int x) {
+	node& n = nodes[x];
+	n.lowest = x;
+	for (int d=0; d<2; d++)
+		if (n.child[d] != -1 && nodes[nodes[n.child[d]].lowest].value < nodes[n.lowest].value)
+			n.lowest = nodes[n.child[d]].lowest;
+}
+
+void dynamicIndex::rotate(int x) {
+	int p = nodes[x].parent;
+	int g = nodes[p].parent;
+	int d = (nodes[p].child[1] == x) ? 1 : 0;
+
+	if (!isRoot(p))
+		nodes[g].child[nodes[g].child[1] == p ? 1 : 0] = x;
+	nodes[x].parent = g;
+	nodes[p].child[d] = nodes[x].child[1-d];
+	if (nodes[x].child[1-d] != -1)
+		nodes[nodes[x].child[1-d]].parent = p;
+	nodes[x].child[1-d] = p;
+	nodes[p].parent = x;
+	update(p);
+	update(x);
+}
+
+void dynamicIndex::splay(int x) {
+	//the pending flips above x have to be pushed down first, from the top
+	stack.clear();
+	for (int y = x; ; y = nodes[y].parent) {
+		stack.push_back(y);
+		if (isRoot(y))
+			break;
+	}
+	for (size_t i=stack.size(); i-- > 0; )
+		push(stack[i]);
+
+	while (!isRoot(x)) {
+		int p = nodes[x].parent;
+		if (!isRoot(p)) {
+			int g = nodes[p].parent;
+			bool zigzig = (nodes[g].child[1] == p) == (nodes[p].child[1] == x);
+			rotate(zigzig ? p : x);
+		}
+		rotate(x);
+	}
+}
+
+//makes the path from the root of the tree to x preferred and splays x to the top of it
+void dynamicIndex::access(int x) {
+	for (int last = -1, y = x; y != -1; last = y, y = nodes[y].parent) {
+		splay(y);
+		nodes[y].child[1] = last;
+		update(y);
+	}
+	splay(x);
+}
+
+void dynamicIndex::makeRoot(int x) {
+	access(x);
+	nodes[x].flip = !nodes[x].flip;
+}
+
+int dynamicIndex::findRoot(int x) {
+	access(x);
+	for (push(x); nodes[x].child[0] != -1; push(x))
+		x = nodes[x].child[0];
+	splay(x);
+	return x;
+}
+
+bool dynamicIndex::connected(int x, int y) {
+	return findRoot(x) == findRoot(y);
+}
+
+void dynamicIndex::link(int x, int y) {
+	makeRoot(x);
+	nodes[x].parent = y;
+}
+
+void dynamicIndex::cut(int x, int y) {
+	makeRoot(x);
+	access(y);
+	//x is now the only node left of y on the path
+	nodes[y].child[0] = -1;
+	nodes[x].parent = -1;
+	update(y);
+}
+
+
+//the forest
+//----------
+
+void dynamicIndex::reset(int count) {
+	cityCount = count;
+	nodes.resize(cityCount);
+	for (int v=0; v<cityCount; v++) {
+		node& n = nodes[v];
+		n.child[0] = n.child[1] = n.parent = -1;
+		n.flip = false;
+		n.value = INT_MAX;
+		n.lowest = v;
+	}
+	roads.clear();
+	freeIds.clear();
+	byTowns.clear();
+	forestAt.assign(cityCount, set<int>());
+	spareAt.assign(cityCount, set<int>());
+	seen.assign(cityCount, 0);
+	stamp = 0;
+}
+
+void dynamicIndex::linkRoad(int id) {
+	road& r = roads[id];
+	r.inForest = true;
+	forestAt[r.a].insert(id);
+	forestAt[r.b].insert(id);
+	link(r.a, cityCount+id);
+	link(cityCount+id, r.b);
+}
+
+void dynamicIndex::cutRoad(int id) {
+	road& r = roads[id];
+	r.inForest = false;
+	forestAt[r.a].erase(id);
+	forestAt[r.b].erase(id);
+	cut(r.a, cityCount+id);
+	cut(cityCount+id, r.b);
+}
+
+void dynamicIndex::addSpare(int id) {
+	roads[id].inForest = false;
+	spareAt[roads[id].a].insert(id);
+	spareAt[roads[id].b].insert(id);
+}
+
+void dynamicIndex::dropSpare(int id) {
+	spareAt[roads[id].a].erase(id);
+	spareAt[roads[id].b].erase(id);
+}
+
+//the widest road outside the forest between the trees of a and b, which were one tree before the road between them
+//was cut, or -1 if there is none. Both trees are searched at the same time, a town at a time, until one of them
+//is done; a road outside the forest lies within the old tree, so a road of a town of that smaller half joins the
+//two trees if its other town was not reached by the search of that half
+int dynamicIndex::replacement(int a, int b) {
+	stamp += 2;
+	int from[2] = {a, b};
+	size_t next[2] = {0, 0};
+	for (int h=0; h<2; h++) {
+		half[h].clear();
+		half[h].push_back(from[h]);
+		seen[from[h]] = stamp + h;
+	}
+
+	int done = -1;
+	while (done == -1) {
+		for (int h=0; h<2 && done == -1; h++) {
+			if (next[h] == half[h].size()) {
+				done = h;
+				break;
+			}
+			int town = half[h][next[h]++];
+			for (set<int>::iterator it = forestAt[town].begin(); it != forestAt[town].end(); ++it) {
+				int other = (roads[*it].a == town) ? roads[*it].b : roads[*it].a;
+				if (seen[other] != stamp + h) {
+					seen[other] = stamp + h;
+					half[h].push_back(other);
+				}
+			}
+		}
+	}
+
+	//of equally wide roads the one with the largest id, as it used to be
+	int best = -1;
+	for (size_t i=0; i<half[done].size(); i++) {
+		int town = half[done][i];
+		for (set<int>::iterator it = spareAt[town].begin(); it != spareAt[town].end(); ++it) {
+			const road& r = roads[*it];
+			int other = (r.a == town) ? r.b : r.a;
+			if (seen[other] == stamp + done)
+				continue;
+			if (best == -1 || r.w > roads[best].w || (r.w == roads[best].w && *it > best))
+				best = *it;
+		}
+	}
+	return best;
+}
+
+//puts a road that is not in the forest where it belongs: in the forest if it joins two trees
+//or is wider than the narrowest road of the loop it closes, otherwise among the spare roads
+void dynamicIndex::insert(int id) {
+	road& r = roads[id];
+	node& n = nodes[cityCount+id];
+	n.child[0] = n.child[1] = n.parent = -1;
+	n.flip = false;
+	n.value = r.w;
+	n.lowest = cityCount+id;
+
+	if (!connected(r.a, r.b)) {
+		linkRoad(id);
+		return;
+	}
+	makeRoot(r.a);
+	access(r.b);
+	int narrowest = nodes[r.b].lowest - cityCount;
+	if (roads[narrowest].w < r.w) {
+		cutRoad(narrowest);
+		addSpare(narrowest);
+		linkRoad(id);
+	}
+	else {
+		addSpare(id);
+	}
+}
+
+void dynamicIndex::setRoad(int a, int b, int w) {
+	if (a == b)
+		return;
+	pair<int, int> key = (a < b) ? make_pair(a, b) : make_pair(b, a);
+	map<pair<int, int>, int>::iterator it = byTowns.find(key);
+
+	if (it == byTowns.end()) {
+		int id;
+		if (freeIds.empty()) {
+			id = roads.size();
+			roads.push_back(road());
+			nodes.push_back(node());
+		}
+		else {
+			id = freeIds.back();
+			freeIds.pop_back();
+		}
+		roads[id].a = a;
+		roads[id].b = b;
+		roads[id].w = w;
+		byTowns[key] = id;
+		insert(id);
+		return;
+	}
+
+	int id = it->second;
+	road& r = roads[id];
+	if (r.inForest && w >= r.w) {
+		//a wider road of the forest stays in the forest, only its value changes
+		access(cityCount+id);
+		r.w = w;
+		nodes[cityCount+id].value = w;
+		update(cityCount+id);
+		return;
+	}
+	removeRoad(a, b);
+	setRoad(a, b, w);
+}
+
+void dynamicIndex::removeRoad(int a, int b) {
+	pair<int, int> key = (a < b) ? make_pair(a, b) : make_pair(b, a);
+	map<pair<int, int>, int>::iterator it = byTowns.find(key);
+	if (it == byTowns.end())
+		return;
+	int id = it->second;
+	byTowns.erase(it);
+	freeIds.push_back(id);
+
+	if (!roads[id].inForest) {
+		dropSpare(id);
+		return;
+	}
+
+	//the tree falls apart in two; the widest spare road between them joins them again
+	cutRoad(id);
+	int other = replacement(roads[id].a, roads[id].b);
+	if (other != -1) {
+		dropSpare(other);
+		linkRoad(other);
+	}
+}
+
+void dynamicIndex::query(int source, int destin, route& result) {
+	result.towns.clear();
+	result.capacity = 0;
+	if (source == destin || !connected(source, destin))
+		return;
+
+	//after this the splay tree of destin holds exactly the path from source to destin
+	makeRoot(source);
+	access(destin);
+	int narrowest = nodes[nodes[destin].lowest].value;
+	if (narrowest <= 0)
+		return;
+	result.capacity = narrowest;
+
+	//in-order walk of the splay tree, keeping the towns and skipping the roads
+	stack.clear();
+	int x = destin;
+	while (x != -1 || !stack.empty()) {
+		while (x != -1) {
+			push(x);
+			stack.push_back(x);
+			x = nodes[x].child[0];
+		}
+		x = stack.back();
+		stack.pop_back();
+		if (x < cityCount)
+			result.towns.push_back(x);
+		x = nodes[x].child[1];
+	}
+}
@@ -0,0 +1,43 @@
+#include "Guide.h"
+#include <cstdio>
+#include <cstring>
+using namespace std;
+
+
+//the roads are read straight into the edges, which are laid out as s, d, t of the file
+static_assert(sizeof(edge) == 3*sizeof(int), "an edge has to be three integers, as a road of the file");
+
+bool readRoadFile(const char* name, int& cityCount, vector<edge>& edges, int& source, int& destin, int& tourists) {
+	FILE* f = fopen(name, "rb");
+	if (f == 0)
+		return false;
+
+	roadFileHeader header;
+	bool valid = fread(&header, sizeof(header), 1, f) == 1 && memcmp(header.magic, "TGR1", 4) == 0
+		&& header.cityCount > 0 && header.roadCount >= 0
+		&& header.source >= 1 && header.source <= header.cityCount
+		&& header.destin >= 1 && header.destin <= header.cityCount;
+	if (valid) {
+		edges.resize(header.roadCount);
+		valid = header.roadCount == 0 || fread(&edges[0], sizeof(edge), header.roadCount, f) == (size_t)header.roadCount;
+	}
+	fclose(f);
+
+	//the towns of every road are used as indices by the graphs, so a road out of the towns makes the whole file wrong
+	for (int i=0; valid && i<header.roadCount; i++) {
+		edge& e = edges[i];
+		if (e.v1 < 1 || e.v1 > header.cityCount || e.v2 < 1 || e.v2 > header.cityCount)
+			valid = false;
+		e.v1--; e.v2--; e.w--;
+	}
+	if (!valid) {
+		edges.clear();
+		return false;
+	}
+
+	cityCount = header.cityCount;
+	source = header.source - 1;
+	destin = header.destin - 1;
+	tourists = header.tourists;
+	return true;
+}
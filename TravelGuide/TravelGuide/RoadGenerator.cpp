@@ -0,0 +1,186 @@
+//generates a road network for TravelGuide, as a scenario of input.txt or as a binary road file (see RoadFile.cpp),
+//so that the solvers can be timed on large networks
+//
+//usage: RoadGenerator kind towns roads capacities seed text|binary output_file
+//
+//kind is one of
+//	grid		the towns are the crossings of a square grid with roads to their neighbours,
+//				and the roads above that go to towns a few blocks away
+//	geometric	the towns are random points and every road joins two towns close to each other
+//	powerlaw	every road starts in a random town and ends in a town picked in proportion to its roads
+//				(preferential attachment), so a few hubs have most of the roads
+//capacities is one of
+//	uniform		2 .. 100 seats
+//	bimodal		most roads are small (2 .. 10 seats), one in five is a highway (50 .. 100 seats)
+//	pareto		heavy tailed: most roads are small and a few are very large
+//the scenario asks for a random number of tourists between two random towns
+//the same seed always gives the same network
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Guide.h"
+using namespace std;
+
+
+//roads from 1 to towns, as in input.txt
+static void gridRoads(int towns, long long roads, mt19937_64& generator, vector<edge>& result) {
+	int side = (int)sqrt((double)towns);
+	if (side < 1)
+		side = 1;
+	for (int v=0; v<towns && (long long)result.size() < roads; v++) {
+		int x = v % side;
+		if (x+1 < side && v+1 < towns)
+			result.push_back(edge(v+1, v+2, 0));
+		if ((long long)result.size() < roads && v+side < towns)
+			result.push_back(edge(v+1, v+side+1, 0));
+	}
+
+	//the remaining roads are shortcuts of up to three blocks
+	uniform_int_distribution<int> town(0, towns-1);
+	uniform_int_distribution<int> step(-3, 3);
+	while ((long long)result.size() < roads) {
+		int v = town(generator);
+		int x = v % side + step(generator), y = v / side + step(generator);
+		int u = y*side + x;
+		if (x < 0 || x >= side || y < 0 || u >= towns || u == v)
+			continue;
+		result.push_back(edge(v+1, u+1, 0));
+	}
+}
+
+static void geometricRoads(int towns, long long roads, mt19937_64& generator, vector<edge>& result) {
+	//the unit square is cut into cells of about four towns; a road joins towns of the same or neighbouring cells
+	int side = (int)sqrt(towns / 4.0);
+	if (side < 1)
+		side = 1;
+	uniform_real_distribution<double> coordinate(0, 1);
+	vector<int> cell(towns);
+	vector<vector<int> > cells((size_t)side*side);
+	for (int v=0; v<towns; v++) {
+		int x = (int)(coordinate(generator) * side), y = (int)(coordinate(generator) * side);
+		cell[v] = y*side + x;
+		cells[cell[v]].push_back(v);
+	}
+
+	uniform_int_distribution<int> town(0, towns-1);
+	uniform_int_distribution<int> step(-1, 1);
+	while ((long long)result.size() < roads) {
+		int v = town(generator);
+		int x = cell[v] % side + step(generator), y = cell[v] / side + step(generator);
+		if (x < 0 || x >= side || y < 0 || y >= side)
+			continue;
+		const vector<int>& near = cells[y*side + x];
+		if (near.empty())
+			continue;
+		int u = near[uniform_int_distribution<size_t>(0, near.size()-1)(generator)];
+		if (u != v)
+			result.push_back(edge(v+1, u+1, 0));
+	}
+}
+
+static void powerLawRoads(int towns, long long roads, mt19937_64& generator, vector<edge>& result) {
+	//ends holds both towns of every road so far, so a town is picked from it in proportion to its roads;
+	//one road in ten goes to a town picked uniformly, so that new towns get their first roads
+	vector<int> ends;
+	ends.reserve((size_t)roads*2);
+	uniform_int_distribution<int> town(0, towns-1);
+	uniform_real_distribution<double> chance(0, 1);
+	while ((long long)result.size() < roads) {
+		int v = town(generator);
+		int u = (ends.empty() || chance(generator) < 0.1) ? town(generator)
+			: ends[uniform_int_distribution<size_t>(0, ends.size()-1)(generator)];
+		if (u == v)
+			continue;
+		result.push_back(edge(v+1, u+1, 0));
+		ends.push_back(v);
+		ends.push_back(u);
+	}
+}
+
+static int seats(const char* capacities, mt19937_64& generator) {
+	uniform_real_distribution<double> chance(0, 1);
+	if (strcmp(capacities, "bimodal") == 0) {
+		if (chance(generator) < 0.2)
+			return uniform_int_distribution<int>(50, 100)(generator);
+		return uniform_int_distribution<int>(2, 10)(generator);
+	}
+	if (strcmp(capacities, "pareto") == 0) {
+		double t = 2 / pow(1 - chance(generator), 1 / 1.5); //shape 1.5, at least 2 seats
+		return t > 1000000 ? 1000000 : (int)t;
+	}
+	return uniform_int_distribution<int>(2, 100)(generator);
+}
+
+
+int main(int argc, char* argv[]) {
+	if (argc != 8) {
+		fprintf(stderr, "Usage: %s grid|geometric|powerlaw towns roads uniform|bimodal|pareto seed text|binary output_file\n", argv[0]);
+		return 1;
+	}
+	const char* kind = argv[1];
+	int towns = atoi(argv[2]);
+	long long roads = atoll(argv[3]);
+	const char* capacities = argv[4];
+	unsigned long long seed = strtoull(argv[5], 0, 10);
+	bool binary = strcmp(argv[6], "binary") == 0;
+
+	if (towns < 2 || roads < 0 || roads > INT_MAX) {
+		fprintf(stderr, "Error: there have to be at least 2 towns and at most %d roads\n", INT_MAX);
+		return 1;
+	}
+	if (strcmp(kind, "grid") != 0 && strcmp(kind, "geometric") != 0 && strcmp(kind, "powerlaw") != 0) {
+		fprintf(stderr, "Error: unknown kind %s\n", kind);
+		return 1;
+	}
+	if (strcmp(capacities, "uniform") != 0 && strcmp(capacities, "bimodal") != 0 && strcmp(capacities, "pareto") != 0) {
+		fprintf(stderr, "Error: unknown capacities %s\n", capacities);
+		return 1;
+	}
+
+	mt19937_64 generator(seed);
+	vector<edge> edges;
+	edges.reserve((size_t)roads);
+	if (strcmp(kind, "grid") == 0)
+		gridRoads(towns, roads, generator, edges);
+	else if (strcmp(kind, "geometric") == 0)
+		geometricRoads(towns, roads, generator, edges);
+	else
+		powerLawRoads(towns, roads, generator, edges);
+	for (size_t i=0; i<edges.size(); i++)
+		edges[i].w = seats(capacities, generator);
+
+	uniform_int_distribution<int> town(1, towns);
+	int source = town(generator), destin = town(generator);
+	int tourists = uniform_int_distribution<int>(1, 100000)(generator);
+
+	FILE* output = fopen(argv[7], binary ? "wb" : "w");
+	if (output == 0) {
+		fprintf(stderr, "Error: output file could not be opened\n");
+		return 1;
+	}
+	if (binary) {
+		roadFileHeader header;
+		memcpy(header.magic, "TGR1", 4);
+		header.cityCount = towns;
+		header.roadCount = (int)edges.size();
+		header.source = source;
+		header.destin = destin;
+		header.tourists = tourists;
+		fwrite(&header, sizeof(header), 1, output);
+		//an edge is three ints, s d t in this order
+		if (!edges.empty())
+			fwrite(&edges[0], sizeof(edge), edges.size(), output);
+	}
+	else {
+		fprintf(output, "%d %d\n", towns, (int)edges.size());
+		for (size_t i=0; i<edges.size(); i++)
+			fprintf(output, "%d %d %d\n", edges[i].v1, edges[i].v2, edges[i].w);
+		fprintf(output, "%d %d %d\n0 0\n", source, destin, tourists);
+	}
+	fclose(output);
+	return 0;
+}
@@ -0,0 +1,135 @@
+#include "Guide.h"
+#include <algorithm>
+using namespace std;
+
+
+static bool wider(const edge& a, const edge& b) {
+	return a.w > b.w;
+}
+
+
+int spanningIndex::find(int v) {
+	while (parent[v] != v) {
+		parent[v] = parent[parent[v]]; //path halving
+		v = parent[v];
+	}
+	return v;
+}
+
+
+void spanningIndex::build(int count, const vector<edge>& edges, int threads) {
+	cityCount = count;
+
+	if (threads > 1) {
+		maximumForest(cityCount, edges, threads, forest);
+	}
+	else {
+		//Kruskal: take the roads from the widest, skipping those that would close a loop
+		sorted = edges;
+		stable_sort(sorted.begin(), sorted.end(), wider);
+		parent.resize(cityCount);
+		for (int v=0; v<cityCount; v++)
+			parent[v] = v;
+		forest.clear();
+		for (size_t i=0; i<sorted.size() && (int)forest.size() < cityCount-1; i++) {
+			int a = find(sorted[i].v1);
+			int b = find(sorted[i].v2);
+			if (a != b) {
+				parent[a] = b;
+				forest.push_back(sorted[i]);
+			}
+		}
+	}
+
+	//rooting every tree with a breadth first search, which gives each town its parent before its children
+	tree.build(cityCount, forest);
+	depth.assign(cityCount, -1);
+	root.assign(cityCount, -1);
+	levels = 1;
+	while ((1 << levels) < cityCount)
+		levels++;
+	up.assign((size_t)levels*cityCount, 0);
+	low.assign((size_t)levels*cityCount, INT_MAX);
+
+	vector<int> order; //towns in the order they are reached
+	order.reserve(cityCount);
+	for (int r=0; r<cityCount; r++) {
+		if (depth[r] != -1)
+			continue;
+		depth[r] = 0;
+		root[r] = r;
+		up[r] = r;
+		order.push_back(r);
+		for (size_t head=order.size()-1; head<order.size(); head++) {
+			int u = order[head];
+			for (int i=tree.first[u]; i<tree.first[u+1]; i++) {
+				int v = tree.to[i];
+				if (depth[v] == -1) {
+					depth[v] = depth[u] + 1;
+					root[v] = r;
+					up[v] = u;
+					low[v] = tree.w[i];
+					order.push_back(v);
+				}
+			}
+		}
+	}
+
+	//the ancestor 2^k roads above is the ancestor 2^(k-1) roads above the ancestor 2^(k-1) roads above
+	for (int k=1; k<levels; k++) {
+		int* upk = &up[(size_t)k*cityCount];
+		int* lowk = &low[(size_t)k*cityCount];
+		const int* upk1 = &up[(size_t)(k-1)*cityCount];
+		const int* lowk1 = &low[(size_t)(k-1)*cityCount];
+		for (int v=0; v<cityCount; v++) {
+			upk[v] = upk1[upk1[v]];
+			lowk[v] = min(lowk1[v], lowk1[upk1[v]]);
+		}
+	}
+}
+
+
+void spanningIndex::query(int source, int destin, route& result) const {
+	result.towns.clear();
+	result.capacity = 0;
+	if (source == destin || root[source] != root[destin])
+		return;
+
+	//lift both towns to the same depth and then together to just below their common ancestor,
+	//keeping the narrowest road passed on the way
+	int a = source, b = destin;
+	int narrowest = INT_MAX;
+	if (depth[a] < depth[b])
+		swap(a, b);
+	for (int k=levels-1; k>=0; k--) {
+		if (depth[a] - (1 << k) >= depth[b]) {
+			narrowest = min(narrowest, low[(size_t)k*cityCount+a]);
+			a = up[(size_t)k*cityCount+a];
+		}
+	}
+	if (a != b) {
+		for (int k=levels-1; k>=0; k--) {
+			if (up[(size_t)k*cityCount+a] != up[(size_t)k*cityCount+b]) {
+				narrowest = min(narrowest, min(low[(size_t)k*cityCount+a], low[(size_t)k*cityCount+b]));
+				a = up[(size_t)k*cityCount+a];
+				b = up[(size_t)k*cityCount+b];
+			}
+		}
+		narrowest = min(narrowest, min(low[a], low[b]));
+		a = up[a];
+	}
+	int common = a;
+
+	result.capacity = (narrowest > 0) ? narrowest : 0;
+	if (result.capacity == 0)
+		return;
+
+	//the route: up from the source to the common ancestor, then down to the destination
+	for (int v = source; v != common; v = up[v])
+		result.towns.push_back(v);
+	result.towns.push_back(common);
+	size_t middle = result.towns.size();
+	for (int v = destin; v != common; v = up[v])
+		result.towns.push_back(v);
+	reverse(result.towns.begin()+middle, result.towns.end());
+}
@@ -1,7 +1,11 @@
 #include <cstdio>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <vector>
 #include <iostream>
+#include <string>
+#include "Guide.h"
 using namespace std;
 
 
@@ -14,172 +18,211 @@ using namespace std;
 
 
 
-//a structure which represents the edge of the graph - two vertexes and the number of passengers it can hold
-struct edge {
-	int v1, v2, w;
-	edge(int a, int b,int c): v1(a), v2(b), w(c) {};
-	edge() {};
-};
+//the routes are found with a modified Dijkstra algorithm over a compressed sparse row graph (see Widest.cpp),
+//so the memory is O(V+E) and a scenario takes O(E log V); the graph and the working memory of the search
+//are kept from one scenario to the next
+//with the option -index the maximum spanning forest is built instead (see SpanningTree.cpp) and reused by all the
+//following scenarios that have the same roads, so that each of them is answered in O(log V) plus the route;
+//-threads N builds the forest on N threads (see Boruvka.cpp)
+//with the option -dynamic the input is a stream of changes to the roads mixed with the questions (see dynamicMode)
+//and the spanning forest is kept up to date after every change (see LinkCut.cpp)
+//with the option -binary file the scenario is read from a binary road file (see RoadFile.cpp) instead of input.txt,
+//and -time prints how long the reading and the solving took, apart from each other
+//benchmark.sh times all of them on large generated networks (see RoadGenerator.cpp); run it from this directory as
+//	bash benchmark.sh [largest_roads] [capacities] [seed]
+
+//prints the answer for one scenario
+void output(ofstream& f2, int N, int trips, const route& r) {
+	f2 << "Scenario #" << N << endl;
+	f2 << "Minimum Number of Trips = " << trips << endl;
+	if (r.towns.empty()) {
+		f2 << "Route = -" << endl << endl;
+		return;
+	}
+	f2 << "Route =";
+	for (size_t i=0; i<r.towns.size(); i++)
+		f2 << " " << r.towns[i] + 1;
+	f2 << endl << endl;
+}
+
+//prints the answer for the tourists on the widest route: if no route takes more than the guide (capacity 0)
+//the destination is unreachable, however the route was found
+void answer(ofstream& f2, int N, int tourists, route& best) {
+	if (best.capacity <= 0) {
+		best.towns.clear();
+		output(f2, N, 0, best);
+		return;
+	}
+	output(f2, N, tripCount(tourists, best.capacity), best); //counting the number of trips
+}
+
+//reads the next scenario of input.txt, false at the end of input
+//the guide takes one seat on the bus so a road holds one passenger less
+bool readScenario(ifstream& f, int& cityCount, vector<edge>& edges, int& source, int& destin, int& tourists) {
+	int roads = 0; //number of edges (roads)
+	cityCount = 0;
+	f >> cityCount >> roads;
+	if (cityCount == 0 && roads == 0) //check whether we reached the end of input
+		return false;
+
+	//scanning input file for the values of edges
+	edges.clear();
+	for (int i=0; i<roads; i++) {
+		int s,d,t;
+		f >> s >> d >> t;
+		s--; d--; t--;
+		edges.push_back(edge(s,d,t));
+	}
+
+	f >> source >> destin >> tourists;
+	source--; destin--;
+	return true;
+}
 
-//print the matrix
-void show(int** matr, int s1, int s2) {
-	for (int** it=matr, i=0; i<s1; it++, i++) {
-		for (int j=0; j<s2; j++) {
-			cout << matr[i][j] << " ";
+//checks whether the scenario has the same roads as the one the index was built for
+bool sameRoads(const vector<edge>& a, const vector<edge>& b) {
+	if (a.size() != b.size())
+		return false;
+	for (size_t i=0; i<a.size(); i++)
+		if (a[i].v1 != b[i].v1 || a[i].v2 != b[i].v2 || a[i].w != b[i].w)
+			return false;
+	return true;
+}
+
+//the input of -dynamic is a number of networks, each of them the number of towns followed by the commands
+//	+ s d t		adds the road from s to d with t seats (or changes its seats if there is one)
+//	- s d		closes the road between s and d
+//	? s d n		the scenario of n tourists going from s to d on the roads open now
+//	.			the end of the network
+//and the number of towns 0 at the end; false if there is a command it doesn't know
+bool dynamicMode(ifstream& f, ofstream& f2) {
+	int N = 0; //number of scenarios
+	dynamicIndex index;
+	route best;
+	int cityCount = 0;
+
+	f >> cityCount;
+	while (cityCount != 0) {
+		index.reset(cityCount);
+		string command;
+		while (f >> command && command != ".") {
+			if (command != "+" && command != "-" && command != "?") {
+				cerr << "Error: unknown command " << command << " in the changes of the roads" << endl;
+				return false;
+			}
+			int s, d;
+			f >> s >> d;
+			s--; d--;
+			if (command == "+") {
+				int t;
+				f >> t;
+				index.setRoad(s, d, t-1); //the seat of the guide
+			}
+			else if (command == "-") {
+				index.removeRoad(s, d);
+			}
+			else {
+				int tourists;
+				f >> tourists;
+				N++;
+				index.query(s, d, best);
+				answer(f2, N, tourists, best);
+			}
 		}
-		cout << endl;
+		cityCount = 0;
+		f >> cityCount;
 	}
+	return true;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+	bool indexed = false, dynamic = false;
+	bool timed = false;
+	const char* binary = 0; //the binary road file to read instead of input.txt
+	int threads = 1; //for building the index
+	for (int i=1; i<argc; i++) {
+		if (string(argv[i]) == "-index")
+			indexed = true;
+		else if (string(argv[i]) == "-dynamic")
+			dynamic = true;
+		else if (string(argv[i]) == "-time")
+			timed = true;
+		else if (string(argv[i]) == "-threads" && i+1 < argc)
+			threads = atoi(argv[++i]);
+		else if (string(argv[i]) == "-binary" && i+1 < argc)
+			binary = argv[++i];
+	}
+
 	//the files we read and write to
 	ifstream f("input.txt", ios::in);
 	ofstream f2("output.txt", ios::out);
 	//     - ?
 
+	if (dynamic) {
+		f2 << "Tigunova Anna" << endl;
+		return dynamicMode(f, f2) ? 0 : 1;
+	}
+
 	//number of scenarios
 	int N = 0;
-
-	int cityCount = 0; //number of towns
-	int roads = 0; //number of edges (roads)
-	f >> cityCount >> roads;
 	f2 << "Tigunova Anna" << endl;
 
-	while (cityCount != 0 || roads !=0) { //check whether we reached the end of input 
-		N++;
-		//check if there's only one town
-		if (cityCount <= 1) {
-			f2 << "Scenario #" << N << endl;
-			f2 << "Minimum Number of Trips = " << 0 << endl;
-			f2 << "Route = -" << endl << endl;
-			int a;
-			f >> a >> a >> a;
-			int b = 12;
+	int cityCount = 0; //number of towns
+	vector<edge> edges; //a vector of edges
+	int source, destin, tourists;
+	route best; //the widest route of the scenario
+	graph g; //the road network of the scenario
+	arena a; //working memory of the search
+	spanningIndex index; //the index for the roads of indexRoads
+	vector<edge> indexRoads;
+	int indexCities = 0;
+	chrono::steady_clock::duration parseTime(0), solveTime(0);
+
+	while (true) {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		bool more;
+		if (binary != 0) {
+			more = (N == 0);
+			if (more && !readRoadFile(binary, cityCount, edges, source, destin, tourists)) {
+				cerr << "Error: " << binary << " is not a road file" << endl;
+				return 1;
+			}
 		}
 		else {
-			int** lengths = new int*[cityCount]; //matrix for passanger count that we use to store the data initially
-			int** paths = new int*[cityCount]; //the matrix that we use for the algorithm
-			vector<edge> edges; //a vector of edges
-			int** precedors = new int*[cityCount]; //a mathix of previous vertexes which will determine a path to the destination
-
-			//initializing the array of passangers with positive infinity (if there is no road)
-			for (int** it=lengths, i=0; i<cityCount; it++, i++) {
-				(*it) = new int[cityCount];
-				for (int j=0; j<cityCount; j++) {
-					lengths[i][j] = INT_MAX;
-				}
-			}
-
-			//initializing supporting matrixes
-			for (int **it2=paths, **it3=precedors, i=0; i<=roads; i++, it2++, it3++) {
-				(*it2) = new int[roads];
-				(*it3) = new int[roads];
-				for (int j=0; j<cityCount; j++) {
-					paths[i][j] = INT_MIN; //every path is still not determined
-					precedors[i][j] = -1;
-				}
-			}
-
-			//scanning input file for the values of edges and writing them into the initial matrix and edges array
-			for (int i=0; i<roads; i++) {
-				int s,d,t;
-				f >> s >> d >> t;
-				s--; d--; t--;
-				lengths[s][d] = lengths[d][s] = t;
-				edges.push_back(edge(s,d,t));
-				edges.push_back(edge(d,s,t));
-			}
+			more = readScenario(f, cityCount, edges, source, destin, tourists);
+		}
+		chrono::steady_clock::time_point parsed = chrono::steady_clock::now();
+		parseTime += parsed - start;
+		if (!more)
+			break;
+		N++;
 
-			int source, destin, tourists;
-
-			f >> source >> destin >> tourists;
-			source--; destin--;
-
-			//initialize the route to the source vertex 
-			paths[0][source] = INT_MAX;
-	
-		
-			/*I am going to use the analog for the ford-bellman algorithm with the exeption that in the supplementary matrix
-			the value of the smallest capacity of the current route to that vertex is
-			One index of this table will be the number of vertex, the other - number of edges which are contained in the current route
-			on each step of the algorithm we take the next vertex and iteratively try to add all the edges so that the stream of passangers through this vertex is maximized
-			First we determine if the capacity of the route through the opposite vertex should change if we add a new edge
-			Second we look if the new route is better than the existing one through the vertex
-			*/
-	
-
-			
-			//show(lengths, cityCount, cityCount);
-			
-			//cout << endl;
-
-			//ford-bellman, modified, so that in the table not minimum distance but the edge with the smallest value is stored
-			for (int i=1; i<cityCount; i++) {//for each edge count
-				for (int j=0; j<edges.size(); j++) {//try to add one more edge
-					if (paths[i][edges[j].v1] < INT_MAX) 
-					{
-						int a = (edges[j].w > paths[i-1][edges[j].v1]) ? paths[i-1][edges[j].v1] : edges[j].w; //if adding the new edge will make the capacity less
-						if (paths[i-1][edges[j].v2] < a) { //if the new route is better
-							//first check if there is a loop
-							bool loop = false;
-							for (int k=0; k<i; k++)
-								if (precedors[k][edges[j].v2] == edges[j].v1)
-									loop = true;
-							//if there is no loop or return to the source
-							if ((!loop) && (i != source)) {
-								paths[i][edges[j].v2] = a;
-								precedors[i][edges[j].v2] = edges[j].v1;
-							}
-						}
-					}
-					//if we should retain the value we got on the previous iteration
-					for (int k=0; k<cityCount; k++)
-						if (paths[i][k] < paths[i-1][k] && paths[i-1][k] != INT_MAX && paths[i-1][k] != INT_MIN)
-							paths[i][k] = paths[i-1][k];
+		//if there's only one town (or the source is the destination) there's nowhere to go
+		best.towns.clear();
+		best.capacity = 0;
+		if (cityCount > 1 && source != destin) {
+			if (indexed) {
+				if (cityCount != indexCities || !sameRoads(edges, indexRoads)) {
+					index.build(cityCount, edges, threads);
+					indexRoads = edges;
+					indexCities = cityCount;
 				}
+				index.query(source, destin, best);
 			}
-
-			
-			show(precedors, roads, cityCount);
-			cout << endl;
-
-			
-			//restoring the shortest path
-			int j=roads-1; //sarting from all the possible routes
-			int* shortest = new int[roads]; //array for precedors of the destination vertex
-			int k = destin; //here we look at the column with the destination vertex
-			int cnt = 0;
-			int minEdge = paths[j][destin]; //the capacity of the route
-			while (j>0) {
-				shortest[cnt] = k+1;
-				cnt++;
-				while (precedors[j][k] == -1 && j>0) {//if adding further edges is pointless
-					j--;
-					minEdge = paths[j][destin]; //because undefined distances can only be lower in the table than the last minimum edge
-				}
-				if (j>0)
-					k = precedors[j][k];//stepping back
-				if (paths[j][k] < minEdge && paths[j][k] > 0)
-					minEdge = paths[j][k];
-				j--;
+			else {
+				g.build(cityCount, edges);
+				widestPath(g, source, destin, a, best);
 			}
-
-
-			//output
-			int numTrips = (tourists % minEdge != 0) ? tourists / minEdge + 1 : tourists / minEdge; //counting the number of trips
-			f2 << "Scenario #" << N << endl;
-			f2 << "Minimum Number of Trips = " << numTrips << endl;
-			f2 << "Route = " << source+1 << " ";
-			for (int i=cnt - 1; i>0; i--)
-				f2 << shortest[i] << " ";
-			f2 << destin + 1 << endl << endl;
-
-			delete(shortest);
-			
 		}
-		f >> cityCount >> roads;
+		solveTime += chrono::steady_clock::now() - parsed;
 
+		answer(f2, N, tourists, best);
 	}
 
+	if (timed) {
+		cerr << "scenarios " << N
+			<< " parse_ms " << chrono::duration<double, milli>(parseTime).count()
+			<< " solve_ms " << chrono::duration<double, milli>(solveTime).count() << endl;
+	}
 	return 0;
-}
\ No newline at end of file
+}
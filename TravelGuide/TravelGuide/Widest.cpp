@@ -0,0 +1,81 @@
+#include "Guide.h"
+#include <algorithm>
+using namespace std;
+
+
+void graph::build(int count, const vector<edge>& edges) {
+	cityCount = count;
+	first.assign(cityCount+1, 0);
+	to.resize(2*edges.size());
+	w.resize(2*edges.size());
+
+	//count the roads of each town, then make first[v] the end of the block of v
+	for (size_t i=0; i<edges.size(); i++) {
+		first[edges[i].v1]++;
+		first[edges[i].v2]++;
+	}
+	for (int v=1; v<cityCount; v++)
+		first[v] += first[v-1];
+	first[cityCount] = 2*edges.size();
+
+	//fill each block from its end, which leaves first[v] at the beginning of the block
+	for (size_t i=edges.size(); i-- > 0; ) {
+		int k = --first[edges[i].v2];
+		to[k] = edges[i].v1;
+		w[k] = edges[i].w;
+		k = --first[edges[i].v1];
+		to[k] = edges[i].v2;
+		w[k] = edges[i].w;
+	}
+}
+
+
+void arena::reset(int cityCount) {
+	width.assign(cityCount, 0);
+	precedor.assign(cityCount, -1);
+	done.assign(cityCount, 0);
+	heap.clear();
+}
+
+
+void widestPath(const graph& g, int source, int destin, arena& a, route& result) {
+	a.reset(g.cityCount);
+
+	a.width[source] = INT_MAX;
+	a.heap.push_back(make_pair(INT_MAX, source));
+	while (!a.heap.empty()) {
+		int u = a.heap.front().second;
+		pop_heap(a.heap.begin(), a.heap.end());
+		a.heap.pop_back();
+		if (a.done[u])
+			continue; //an old entry, the town was improved after it was pushed
+		a.done[u] = 1;
+		if (u == destin)
+			break; //no route to the destination can get wider any more
+
+		for (int i=g.first[u]; i<g.first[u+1]; i++) {
+			int v = g.to[i];
+			int w = (g.w[i] < a.width[u]) ? g.w[i] : a.width[u]; //the route through u is as wide as its narrowest road
+			if (w > a.width[v]) {
+				a.width[v] = w;
+				a.precedor[v] = u;
+				a.heap.push_back(make_pair(w, v));
+				push_heap(a.heap.begin(), a.heap.end());
+			}
+		}
+	}
+
+	//restoring the route by stepping back from the destination
+	result.towns.clear();
+	result.capacity = (destin != source && a.precedor[destin] != -1) ? a.width[destin] : 0;
+	if (result.capacity == 0)
+		return;
+	for (int k = destin; k != -1; k = a.precedor[k])
+		result.towns.push_back(k);
+	reverse(result.towns.begin(), result.towns.end());
+}
+
+
+int tripCount(int tourists, int capacity) {
+	return (tourists % capacity != 0) ? tourists / capacity + 1 : tourists / capacity;
+}
@@ -0,0 +1,57 @@
+#!/bin/bash
+
+# Benchmark of TravelGuide on large road networks: seeded grid, geometric and power law networks of 10^3 .. 10^7
+# roads are answered from input.txt and from the binary road file, with the widest path search, the serial index
+# and the parallel index (Boruvka on every core). The time of reading the network and the time of solving it are
+# reported apart, and every way has to give the same number of trips. Run from this directory; everything is
+# built and written in ./benchmark
+#
+#   bash benchmark.sh [largest_roads] [capacities] [seed]
+
+LARGEST=${1:-10000000}
+CAPACITIES=${2:-uniform}
+SEED=${3:-2014}
+THREADS=$(nproc)
+
+mkdir -p benchmark
+g++ -O2 -fopenmp -o benchmark/tour Tour.cpp Widest.cpp SpanningTree.cpp LinkCut.cpp Boruvka.cpp RoadFile.cpp || exit 1
+g++ -O2 -o benchmark/generator RoadGenerator.cpp || exit 1
+cd benchmark
+
+echo "kind       roads     format mode          parse_ms   solve_ms"
+for KIND in grid geometric powerlaw; do
+    for ROADS in 1000 10000 100000 1000000 10000000; do
+        if [ $ROADS -gt $LARGEST ]; then
+            continue
+        fi
+        TOWNS=$((ROADS / 4))
+        ./generator $KIND $TOWNS $ROADS $CAPACITIES $SEED text input.txt || exit 1
+        ./generator $KIND $TOWNS $ROADS $CAPACITIES $SEED binary roads.bin || exit 1
+
+        TRIPS=""
+        for FORMAT in text binary; do
+            for MODE in widest index parallel; do
+                ARGUMENTS="-time"
+                if [ $FORMAT = binary ]; then
+                    ARGUMENTS="$ARGUMENTS -binary roads.bin"
+                fi
+                if [ $MODE = index ]; then
+                    ARGUMENTS="$ARGUMENTS -index"
+                elif [ $MODE = parallel ]; then
+                    ARGUMENTS="$ARGUMENTS -index -threads $THREADS"
+                fi
+                ./tour $ARGUMENTS 2> time.txt || exit 1
+                awk -v kind=$KIND -v roads=$ROADS -v format=$FORMAT -v mode=$MODE \
+                    '{ printf "%-9s %9d %-6s %-12s %10.2f %10.2f\n", kind, roads, format, mode, $4, $6 }' time.txt
+
+                # the routes may differ between equally wide ones, the number of trips may not
+                if [ -z "$TRIPS" ]; then
+                    TRIPS=$(sed -n 3p output.txt)
+                elif [ "$TRIPS" != "$(sed -n 3p output.txt)" ]; then
+                    echo "the number of trips differs: $TRIPS, $(sed -n 3p output.txt)"
+                    exit 1
+                fi
+            done
+        done
+    done
+done
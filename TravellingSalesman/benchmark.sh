@@ -0,0 +1,41 @@
+#!/bin/bash
+
+# Benchmark of the travelling salesman solvers: the same seeded corpus of random and structured asymmetric
+# instances is solved by every solver, and the statistics of each test case are summarised per solver and size.
+# Run from this directory; everything is built and written in ./benchmark
+#
+#   bash benchmark.sh [test_cases_per_size] [seed]
+
+CASES=${1:-10}
+SEED=${2:-2014}
+DEADLINE=2000
+
+mkdir -p benchmark
+g++ -O2 -fopenmp -pthread -o benchmark/tsp travellingSalesmanApplication.cpp travellingSalesmanImplementation.cpp \
+    travellingSalesmanBatch.cpp travellingSalesmanHeldKarp.cpp travellingSalesmanAnytime.cpp || exit 1
+g++ -O2 -o benchmark/generator travellingSalesmanGenerator.cpp || exit 1
+cd benchmark
+
+# largest number of shops given to each solver, so that the corpus finishes in minutes
+declare -A LARGEST=([backtrack]=12 [table]=14 [heldkarp]=22 [anytime]=22)
+
+echo "kind      shops solver     cases   mean_ms    max_ms      nodes_mean  first_ms  gap_cases"
+for KIND in random hills clusters; do
+    for SHOPS in 6 8 10 12 14 16 18 20 22; do
+        ./generator $KIND $SHOPS $CASES $SEED instances_${KIND}_${SHOPS}.txt
+        for SOLVER in backtrack table heldkarp anytime; do
+            if [ $SHOPS -gt ${LARGEST[$SOLVER]} ]; then
+                continue
+            fi
+            cp instances_${KIND}_${SHOPS}.txt input.txt
+            ./tsp $SOLVER -deadline $DEADLINE -statistics statistics_${KIND}_${SHOPS}_${SOLVER}.csv > /dev/null
+            awk -F, -v kind=$KIND -v shops=$SHOPS -v solver=$SOLVER 'NR > 1 {
+                    n++; total += $12; nodes += $5; first += $10
+                    if ($12 > max) max = $12
+                    if ($4 < $3) gaps++
+                }
+                END { printf "%-9s %5d %-10s %5d %9.2f %9.2f %14.0f %9.3f %10d\n",
+                      kind, shops, solver, n, total/n, max, nodes/n, first/n, gaps }' statistics_${KIND}_${SHOPS}_${SOLVER}.csv
+        done
+    done
+done
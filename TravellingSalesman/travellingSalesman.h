@@ -84,6 +84,10 @@
    The solution uses combinatorial search with backtracking so we seek the permutation of the shops that provided the minimum length tour 
    Instead of enumerating permutations of the shop names we associate an integer key with each shop name and form permutations of these keys.
 
+   The number of shops and the length of the names are not limited: each test case is read into a dynamically sized
+   instance_type by a streaming parser that scans a fixed-size input buffer, so one binary handles arbitrarily large files.
+   The search itself is hidden behind the solver_type interface so that the application does not depend on the strategy used.
+
 
    David Vernon
    17 November 2014
@@ -93,17 +97,231 @@
 #include "stdlib.h"
 #include "string.h"
 #include <limits.h>
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
 #define TRUE 1
 #define FALSE 0
-#define STRING_SIZE 80
-#define NUMBER_OF_STOPS 11
+#define READER_BUFFER_SIZE 65536
+#define TABLE_WAYS 4                   // entries per bucket of the transposition table
+#define MAX_TABLE_SHOPS 64             // the set of visited shops is kept in a 64-bit mask
+#define MAX_HELD_KARP_SHOPS 30         // the sets of shops of the Held-Karp table are indexed by a 32-bit mask
+
+
+/* data structure to represent one test case */
+/* the shops are numbered 0 .. stops-2 in the order they are given; the car is always the last stop, stops-1 */
+
+struct instance_type {
+   int number;                         // the number of the test case in the input file, starting at 1
+   int stops;                          // number of shops plus one for the car
+   std::vector<std::string> names;     // the strings representing the shop names and the car name
+   std::vector<int> distances;         // stops x stops matrix, row-major: distances[i*stops+j] is the distance from stop i to stop j
+
+   int distance(int i, int j) const { return distances[i*stops+j]; }
+   int car() const { return stops-1; }
+};
+
+
+/* counters describing how a test case was solved; the times are in milliseconds from the start of the search */
+
+struct statistics_type {
+   long long nodes;                    // partial routes (or Held-Karp entries) expanded
+   long long bound_prunes;             // partial routes cut because they can't be shorter than the best tour
+   long long table_prunes;             // partial routes cut because the transposition table holds one at least as short
+   long long deadline_prunes;          // branches abandoned because the deadline had passed
+   long long incumbents;               // number of times the best tour improved
+   double first_time;                  // time to the first tour
+   double best_time;                   // time to the tour returned
+   double total_time;                  // time to the end of the search
+   std::chrono::steady_clock::time_point start;
+};
+
+
+/* data structure to represent a tour: the sequence of stops starts and ends at the car */
+
+struct tour_type {
+   long long cost;                     // total distance walked
+   long long lower_bound;              // no tour is shorter than this; equal to cost when the tour is known to be optimal
+   std::vector<int> stops;             // the stops in the order they are visited
+   statistics_type statistics;         // how the tour was found
+};
+
+
+/* state of the streaming parser: the input file is scanned through a fixed-size buffer, */
+/* so parsing a test case never allocates anything beyond the instance itself           */
+
+struct reader_type {
+   FILE *fp;
+   char buffer[READER_BUFFER_SIZE];
+   int  position;                      // next unread character in buffer
+   int  length;                        // number of valid characters in buffer
+   int  test_cases;                    // number of test cases read so far
+};
 
 
-/* data structure to represent a shop or car */
+/* function called with every tour that improves on the best one found so far, while a test case is being solved */
 
-struct record_type {
-   int  key;                  // an integer that will be used in the permutation instead of the string
-   char string[STRING_SIZE];  // the string representing the shop name or car name
+typedef void (*incumbent_function)(const instance_type &instance, const tour_type &tour);
+
+
+/* the interface shared by every search strategy */
+
+class solver_type {
+public:
+   virtual ~solver_type() {}
+
+   /* find the minimum length tour for the instance; returns FALSE if the instance has no tour */
+
+   virtual bool solve(const instance_type &instance, tour_type &tour) = 0;
+};
+
+
+/* exhaustive search using backtracking; the shops are tried in decreasing order of their number so that    */
+/* if several tours have the same minimum length the one selected is the first one the original search found */
+
+class backtracking_solver : public solver_type {
+public:
+   bool solve(const instance_type &instance, tour_type &tour);
+
+private:
+   void extend(int depth, int last, long long cost);
+
+   const instance_type *instance;
+   std::vector<char> visited;          // visited[i] is TRUE if shop i is in the current partial route
+   std::vector<int>  route;            // the current partial route, route[0] is the car
+   tour_type *best;                    // the best complete tour found so far
+};
+
+
+/* settings given on the command line */
+
+struct options_type {
+   const char *solver;                 // name of the search strategy, see create_solver
+   int threads;                        // number of test cases solved at the same time; 1 solves them one after another
+   int window;                         // maximum number of test cases read but not yet written in batch mode
+   size_t table_memory;                // bytes of memory for the transposition table of each solver
+   size_t held_karp_memory;            // bytes of memory for the Held-Karp tables of each solver
+   long deadline;                      // milliseconds allowed for each test case by the anytime solver
+   incumbent_function report;          // if not 0 the anytime solver reports every improved tour to this function
+   const char *statistics;             // if not 0 the statistics of each test case are written to this file
+   bool debug;                         // print the test cases and their statistics on the console
+};
+
+
+/* function used to write the result of one test case */
+
+typedef void (*write_function)(FILE *fp_out, int test_case, const instance_type &instance, const tour_type &tour);
+
+
+/* transposition table: two partial routes that visited the same set of shops and end at the same shop are       */
+/* interchangeable, so a route is dominated if the table already holds one at least as short for the same state. */
+/* The table has a fixed number of buckets of TABLE_WAYS entries; when a bucket is full the clock algorithm      */
+/* evicts an entry that has not been referenced since the hand last passed it.                                  */
+
+struct table_bucket_type {
+   uint64_t  visited[TABLE_WAYS];      // the set of visited shops, one bit per shop
+   long long cost[TABLE_WAYS];         // the shortest partial route seen for the state
+   int16_t   last[TABLE_WAYS];         // the shop the route ends at, -1 if the entry is empty
+   uint8_t   referenced;               // one bit per entry, set when the entry is used
+   uint8_t   hand;                     // the next entry the clock will consider for eviction
+};
+
+class transposition_table {
+public:
+   /* make the table empty, with enough buckets for the states of the given number of shops but no more than memory bytes */
+
+   void reset(int shops, size_t memory);
+
+   /* returns TRUE if a route at least as short as cost is known for the state; otherwise records cost for the state */
+
+   bool dominated(uint64_t visited, int last, long long cost);
+
+private:
+   std::vector<table_bucket_type> buckets;
+   size_t mask;                        // number of buckets in use minus one, a power of two minus one
+};
+
+
+/* backtracking cut by the transposition table as well as by the length of the best tour; */
+/* uses at most the given number of bytes for the table, and selects the same tour as backtracking_solver */
+
+class table_solver : public solver_type {
+public:
+   table_solver(size_t memory): memory(memory) {}
+
+   bool solve(const instance_type &instance, tour_type &tour);
+
+private:
+   void extend(int depth, int last, uint64_t visited, long long cost);
+
+   size_t memory;
+   transposition_table table;
+   const instance_type *instance;
+   std::vector<int> route;
+   tour_type *best;
+};
+
+
+/* dynamic programming over the sets of shops (Held-Karp) in O(2^n n^2) time and 2^(n-1) n entries of memory:  */
+/* cost(R, j) is the length of the shortest route from shop j through all the shops of R (without j) to the car. */
+/* The sets are processed layer by layer, by number of shops, and the sets of a layer in parallel with OpenMP,  */
+/* each thread going through its chunk of them in increasing order. Lengths are kept in 16 or 32 bits when     */
+/* every tour fits, so that the minimum over the next shop is vectorized, and the next shop is packed in 5 bits */
+/* per entry. Of the shortest tours the one selected is the same as backtracking_solver's. Test cases that     */
+/* would need more memory than allowed use table_solver, with a note on stderr.                                */
+
+class held_karp_solver : public solver_type {
+public:
+   held_karp_solver(size_t memory, size_t table_memory): memory(memory), fallback(table_memory) {}
+
+   bool solve(const instance_type &instance, tour_type &tour);
+
+private:
+   template <typename cost_t> void search(const instance_type &instance, tour_type &tour, std::vector<cost_t> &costs);
+
+   size_t memory;
+   table_solver fallback;
+   std::vector<uint16_t> costs16;
+   std::vector<uint32_t> costs32;
+   std::vector<uint64_t> costs64;
+   std::vector<uint64_t> next;         // the shop that follows j on the shortest route for cost(R, j), 5 bits each, 12 to a word
+};
+
+
+/* anytime search: the first tour is found greedily, then backtracking (with the transposition table when there  */
+/* are at most MAX_TABLE_SHOPS shops) improves it until the search is complete or the deadline for the test case */
+/* has passed. Every improved tour is reported as it is found. When the deadline stops the search the tour comes  */
+/* with a lower bound proven from the branches that were not completed; otherwise the tour is the one            */
+/* backtracking_solver selects.                                                                                  */
+
+class anytime_solver : public solver_type {
+public:
+   anytime_solver(long deadline, size_t table_memory, incumbent_function report):
+      deadline(deadline), table_memory(table_memory), report(report) {}
+
+   bool solve(const instance_type &instance, tour_type &tour);
+
+private:
+   void greedy();
+   void extend(int depth, int last, uint64_t visited, long long cost, long long rest);
+   void improve(int depth, long long cost);
+
+   long deadline;                      // milliseconds allowed for each test case
+   size_t table_memory;
+   incumbent_function report;
+   transposition_table table;
+   bool use_table;
+   bool expired;                       // TRUE once the deadline has passed
+   long nodes;                         // partial routes extended since the clock was last read
+   std::chrono::steady_clock::time_point stop_time;
+
+   const instance_type *instance;
+   std::vector<long long> shortest_exit;  // shortest_exit[i] is the shortest distance from stop i to any other stop
+   std::vector<char> on_route;
+   std::vector<int> route;
+   long long bound;                    // the search looks for tours shorter than this
+   tour_type *best;
 };
 
 
@@ -114,3 +332,59 @@ struct record_type {
 
 void remove_new_line(char string[]);
 
+/* open the input file for streaming; returns FALSE if the file can't be opened */
+
+bool open_reader(reader_type *reader, const char *filename);
+
+void close_reader(reader_type *reader);
+
+/* read the next integer, skipping any white space before it; returns FALSE at the end of the file */
+
+bool read_integer(reader_type *reader, int *value);
+
+/* read the rest of the current line into line, without the end of line characters */
+
+bool read_line(reader_type *reader, std::string &line);
+
+/* read one test case; the storage of the instance is reused so consecutive test cases don't reallocate */
+
+bool read_test_case(reader_type *reader, instance_type *instance);
+
+/* create the solver named in the options: backtrack, table, heldkarp or anytime; returns 0 if the name is not known */
+
+solver_type *create_solver(const options_type &options);
+
+/* read the options -threads n, -window n, -table-memory megabytes, -held-karp-memory megabytes, -deadline milliseconds, */
+/* -progress (print every improved tour), -statistics filename, -debug and the name of the solver;                     */
+/* returns FALSE if an option is not valid */
+
+bool parse_options(int argc, char *argv[], options_type *options);
+
+/* batch mode: read the test cases ahead, solve them on options.threads threads (each with its own solver)  */
+/* and write the results strictly in the order of the test cases; at most options.window test cases are    */
+/* held in memory, so a slow test case stalls the reading instead of letting the finished ones pile up     */
+/* returns the number of test cases written                                                               */
+
+int solve_batch(reader_type *reader, int number_of_test_cases, const options_type &options, FILE *fp_out, write_function write);
+
+/* write the test case number, the length of the tour and the names of the stops, each on a separate line; */
+/* if the tour is not known to be optimal this is followed by the lower bound and the optimality gap        */
+
+void write_tour(FILE *fp_out, int test_case, const instance_type &instance, const tour_type &tour);
+
+/* statistics: reset the counters and start the clock, count an improved tour, stop the clock */
+
+void start_statistics(statistics_type *statistics);
+
+void count_incumbent(statistics_type *statistics);
+
+void stop_statistics(statistics_type *statistics);
+
+/* write the statistics of a test case as one comma separated line; with a test case number of 0 write the names of the columns */
+
+void write_statistics(FILE *fp, int test_case, const instance_type &instance, const tour_type &tour);
+
+/* print an improved tour on the console */
+
+void print_incumbent(const instance_type &instance, const tour_type &tour);
+
@@ -0,0 +1,181 @@
+/*
+
+  travellingSalesmanAnytime.cpp - anytime solution of the travelling saleman problem:
+  the best tour found so far is always available and the search stops at a deadline
+
+  See travellingSalesman.h for details of the problem
+
+*/
+
+#include "travellingSalesman.h"
+
+#define NODES_BETWEEN_CLOCK_READS 1024
+
+
+static uint64_t shop_bit(int shop) {
+   return shop < MAX_TABLE_SHOPS ? (uint64_t) 1 << shop : 0;
+}
+
+
+bool anytime_solver::solve(const instance_type &instance, tour_type &tour) {
+   int i, j;
+   int car = instance.car();
+   long long rest = 0;
+   long long proven = LLONG_MAX;       // lower bound of the branches the deadline stopped
+
+   this->instance = &instance;
+   best = &tour;
+   start_statistics(&best->statistics);
+   stop_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(deadline);
+   expired = FALSE;
+   nodes = 0;
+
+   /* the shortest way out of each stop: a route from a shop through the shops it hasn't visited to the car */
+   /* leaves each of them once, so the sum of their shortest exits is a lower bound on what it still needs */
+
+   shortest_exit.resize(instance.stops);
+   for (i = 0; i < instance.stops; i++) {
+      shortest_exit[i] = LLONG_MAX;
+      for (j = 0; j < instance.stops; j++)
+         if (j != i && instance.distance(i, j) < shortest_exit[i])
+            shortest_exit[i] = instance.distance(i, j);
+      if (shortest_exit[i] == LLONG_MAX)
+         shortest_exit[i] = 0;
+   }
+   for (i = 0; i < car; i++)
+      rest += shortest_exit[i];
+
+   on_route.assign(instance.stops, FALSE);
+   route.resize(instance.stops+1);
+   route[0] = car;
+
+   /* a first tour at once; backtracking then looks for tours no longer than it, so that it still finds */
+   /* the tour backtracking_solver would select even if that one is exactly as long as the greedy one   */
+
+   greedy();
+   bound = best->cost + 1;
+
+   use_table = car <= MAX_TABLE_SHOPS;
+   if (use_table)
+      table.reset(car, table_memory);
+
+   for (j = car-1; j >= 0; j--) {
+      long long branch = instance.distance(car, j) + rest;
+
+      if (expired) {
+         best->statistics.deadline_prunes++;
+      }
+      else if (branch >= bound) {
+         best->statistics.bound_prunes++;
+         continue;
+      }
+      else {
+         on_route[j] = TRUE;
+         route[1] = j;
+         extend(1, j, shop_bit(j), instance.distance(car, j), rest - shortest_exit[j]);
+         on_route[j] = FALSE;
+      }
+
+      if (expired && branch < proven)
+         proven = branch;
+   }
+
+   stop_statistics(&best->statistics);
+   best->lower_bound = best->cost;
+   if (expired && proven < best->cost)
+      best->lower_bound = proven;
+   return TRUE;
+}
+
+
+/* nearest neighbour: always walk to the closest shop not visited yet (the one with the largest number if there are several) */
+
+void anytime_solver::greedy() {
+   int i, depth;
+   int car = instance->car();
+   int last = car;
+   long long cost = 0;
+
+   for (depth = 1; depth <= car; depth++) {
+      int next = -1;
+      for (i = car-1; i >= 0; i--)
+         if (!on_route[i] && (next == -1 || instance->distance(last, i) < instance->distance(last, next)))
+            next = i;
+      on_route[next] = TRUE;
+      route[depth] = next;
+      cost += instance->distance(last, next);
+      last = next;
+   }
+   for (i = 0; i < car; i++)
+      on_route[i] = FALSE;
+
+   best->cost = LLONG_MAX;
+   improve(car, cost + instance->distance(last, car));
+}
+
+
+/* route[0..depth] followed by the car is a tour of the given length shorter than the best one */
+
+void anytime_solver::improve(int depth, long long cost) {
+   route[depth+1] = instance->car();
+   bound = cost;
+
+   if (cost < best->cost) {
+      best->cost = cost;
+      best->lower_bound = LLONG_MIN;
+      best->stops.assign(route.begin(), route.begin()+depth+2);
+      count_incumbent(&best->statistics);
+      if (report != 0)
+         report(*instance, *best);
+   }
+   else {
+      best->stops.assign(route.begin(), route.begin()+depth+2);
+   }
+}
+
+
+/* the search of table_solver, cut also when the lower bound of the rest of the route can't beat the bound, */
+/* and stopped as soon as the deadline has passed; rest is the sum of the shortest exits of the shops that  */
+/* have not been visited                                                                                     */
+
+void anytime_solver::extend(int depth, int last, uint64_t visited, long long cost, long long rest) {
+   int i;
+   int car = instance->car();
+
+   if (++nodes == NODES_BETWEEN_CLOCK_READS) {
+      nodes = 0;
+      if (std::chrono::steady_clock::now() >= stop_time)
+         expired = TRUE;
+   }
+   if (expired) {
+      best->statistics.deadline_prunes++;
+      return;
+   }
+
+   if (cost + shortest_exit[last] + rest >= bound) {
+      best->statistics.bound_prunes++;
+      return;
+   }
+
+   if (use_table && table.dominated(visited, last, cost)) {
+      best->statistics.table_prunes++;
+      return;
+   }
+   best->statistics.nodes++;
+
+   if (depth == car) {
+      cost += instance->distance(last, car);
+      if (cost < bound)
+         improve(depth, cost);
+      return;
+   }
+
+   for (i = car-1; i >= 0 && !expired; i--) {
+      if (!on_route[i]) {
+         on_route[i] = TRUE;
+         route[depth+1] = i;
+         extend(depth+1, i, visited | shop_bit(i), cost + instance->distance(last, i), rest - shortest_exit[i]);
+         on_route[i] = FALSE;
+      }
+   }
+}
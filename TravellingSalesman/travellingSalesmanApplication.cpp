@@ -13,24 +13,50 @@
  
 #include "travellingSalesman.h"
 
-int main() {
+static FILE *fp_statistics = 0;                      // file the statistics of each test case are written to, if any
+static bool debug = FALSE;                           // flag: if TRUE print information to assist with debugging
 
-   struct record_type record[NUMBER_OF_STOPS];
+
+/* write the tour of a test case, and its statistics if they are wanted */
+
+static void write_result(FILE *fp_out, int test_case, const instance_type &instance, const tour_type &tour) {
+   write_tour(fp_out, test_case, instance, tour);
+   if (fp_statistics != 0)
+      write_statistics(fp_statistics, test_case, instance, tour);
+   if (debug)
+      write_statistics(stdout, test_case, instance, tour);
+}
+
+
+int main(int argc, char *argv[]) {
+
+   instance_type instance;                           // the current test case; its storage is reused for every test case
+   tour_type tour;                                   // the best tour for the current test case
+   reader_type reader;                               // streaming parser for the input file
+   solver_type *solver;                              // the search strategy
+   options_type options;                             // the search strategy and the number of threads
 
    int i, j, k;                                      // general purpose counters
-   int n;                                            // number of shops
    int number_of_test_cases;                         //
-   char shop_name[STRING_SIZE];                      // general purpose string
-   int distances[NUMBER_OF_STOPS][NUMBER_OF_STOPS];  // distances between shop i (row) and shop j (column)
-   
-   int debug = TRUE;                                 // flag: if TRUE print information to assist with debugging
 
-   FILE *fp_in, *fp_out;                             // input and output file pointers
+   FILE *fp_out;                                     // output file pointer
+
 
+   if (!parse_options(argc, argv, &options)) {
+	   printf("Usage: %s [solver] [-threads n] [-window n] [-table-memory megabytes] [-held-karp-memory megabytes] [-deadline milliseconds] [-progress]\n"
+             "          [-statistics filename] [-debug]\n", argv[0]);
+      exit(0);
+   }
+   debug = options.debug;
+
+   if ((solver = create_solver(options)) == 0) {
+	   printf("Error unknown solver %s\n", options.solver);
+      exit(0);
+   }
 
    /* open input and output files */
 
-   if ((fp_in = fopen("input.txt","r")) == 0) {
+   if (!open_reader(&reader, "input.txt")) {
 	   printf("Error can't open input input.txt\n");
       exit(0);
    }
@@ -40,53 +66,53 @@ int main() {
       exit(0);
    }
 
+   if (options.statistics != 0) {
+      if ((fp_statistics = fopen(options.statistics, "w")) == 0) {
+	      printf("Error can't open statistics %s\n", options.statistics);
+         exit(0);
+      }
+      write_statistics(fp_statistics, 0, instance, tour);
+   }
+   if (debug)
+      write_statistics(stdout, 0, instance, tour);
+
+   fprintf(fp_out, "David Vernon\n");
+
    /* read the number of test cases */
 
-   fscanf(fp_in, "%d", &number_of_test_cases);
-   fgetc(fp_in); // move past end of line for subsequent fgets; fgets fails unless we do this
+   if (!read_integer(&reader, &number_of_test_cases))
+      number_of_test_cases = 0;
 
    if (debug) printf ("%d\n", number_of_test_cases);
 
 
+   /* batch mode: the test cases are solved concurrently and written in the same order, so nothing is left for the main loop */
+
+   if (options.threads > 1) {
+      solve_batch(&reader, number_of_test_cases, options, fp_out, write_result);
+      number_of_test_cases = 0;
+   }
+
+
    /* main processing loop, one iteration for each test case */
 
    for (k=0; k<number_of_test_cases; k++) {
 
       /* read the data for each test case  */
       /* --------------------------------  */
-      
-      /* number of shops */
-
-      fscanf(fp_in, "%d", &n);
-      fgetc(fp_in);  // move past end of line for subsequent fgets
-
-      if (debug) printf ("%d\n",n);
-
-      /* get the shop names and the car name */
-
-      for (i = 0; i < n+1; i++) {
 
-         fgets(shop_name, STRING_SIZE, fp_in);
-         remove_new_line(shop_name);
-
-         record[i].key = i+1;
-         strcpy(record[i].string,shop_name);
-
-         if (debug) printf ("%s\n",record[i].string);
-      }
-
-      /* get the matrix of distances */
-
-      for (i = 0; i < n+1; i++) {
-         for (j = 0; j < n+1; j++) {
-            fscanf(fp_in, "%d", &(distances[i][j]));
-         }
+      if (!read_test_case(&reader, &instance)) {
+	      printf("Error test case %d is incomplete\n", k+1);
+         break;
       }
 
       if (debug) {
-         for (i = 0; i < n+1; i++) {
-            for (j = 0; j < n+1; j++) {
-               printf("%3d ", distances[i][j]);
+         printf ("%d\n", instance.stops-1);
+         for (i = 0; i < instance.stops; i++)
+            printf ("%s\n", instance.names[i].c_str());
+         for (i = 0; i < instance.stops; i++) {
+            for (j = 0; j < instance.stops; j++) {
+               printf("%3d ", instance.distance(i, j));
             }
             printf("\n");
          }
@@ -96,11 +122,14 @@ int main() {
       /* main processing begins here */
       /* --------------------------- */
 
- 
-      if (debug) getchar();
+      if (solver->solve(instance, tour))
+         write_result(fp_out, k+1, instance, tour);
 
    }
 
-   fclose(fp_in);
+   delete solver;
+   close_reader(&reader);
+   if (fp_statistics != 0)
+      fclose(fp_statistics);
    fclose(fp_out);                                                         
-}
\ No newline at end of file
+}
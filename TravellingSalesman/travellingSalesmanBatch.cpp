@@ -0,0 +1,132 @@
+/*
+
+  travellingSalesmanBatch.cpp - batch mode for the solution of the travelling saleman problem:
+  independent test cases are solved concurrently and written in their original order
+
+  See travellingSalesman.h for details of the problem
+
+*/
+
+#include "travellingSalesman.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+/* a test case travels through a slot of the reorder buffer: it is read into the slot, */
+/* solved by one of the workers and written out when all the earlier ones are written */
+
+#define SLOT_READ   0
+#define SLOT_SOLVED 1
+#define SLOT_FAILED 2
+
+struct slot_type {
+   instance_type instance;
+   tour_type tour;
+   int state;
+};
+
+
+/* state shared by the reading/writing thread and the workers; slot i holds test case i modulo the window */
+
+struct batch_type {
+   std::vector<slot_type> slots;
+   int read;                           // number of test cases read so far
+   int taken;                          // number of test cases given to a worker
+   int written;                        // number of test cases written
+   bool finished;                      // no more test cases will be read
+
+   std::mutex lock;
+   std::condition_variable work_ready;  // signalled when a test case has been read or the input is finished
+   std::condition_variable work_done;   // signalled when a test case has been solved
+};
+
+
+static void worker(batch_type *batch, const options_type *options) {
+   solver_type *solver = create_solver(*options);
+   std::unique_lock<std::mutex> guard(batch->lock);
+
+   while (TRUE) {
+      while (batch->taken == batch->read && !batch->finished)
+         batch->work_ready.wait(guard);
+      if (batch->taken == batch->read)
+         break;
+
+      slot_type &slot = batch->slots[batch->taken % batch->slots.size()];
+      batch->taken++;
+
+      /* the slot can't be reused before it is written, so it is safe to solve it unlocked */
+
+      guard.unlock();
+      bool solved = solver->solve(slot.instance, slot.tour);
+      guard.lock();
+
+      slot.state = solved ? SLOT_SOLVED : SLOT_FAILED;
+      batch->work_done.notify_all();
+   }
+
+   delete solver;
+}
+
+
+int solve_batch(reader_type *reader, int number_of_test_cases, const options_type &options, FILE *fp_out, write_function write) {
+   int i;
+   batch_type batch;
+   std::vector<std::thread> workers;
+
+   batch.slots.resize(options.window);
+   batch.read = batch.taken = batch.written = 0;
+   batch.finished = FALSE;
+
+   for (i = 0; i < options.threads; i++)
+      workers.push_back(std::thread(worker, &batch, &options));
+
+   std::unique_lock<std::mutex> guard(batch.lock);
+
+   while (batch.written < batch.read || !batch.finished) {
+
+      /* read ahead as long as there is a free slot; the reading is done unlocked since the workers never touch a slot before it is counted in read */
+
+      while (!batch.finished && batch.read - batch.written < (int) batch.slots.size()) {
+         if (batch.read == number_of_test_cases) {
+            batch.finished = TRUE;
+         }
+         else {
+            slot_type &slot = batch.slots[batch.read % batch.slots.size()];
+            guard.unlock();
+            bool complete = read_test_case(reader, &slot.instance);
+            guard.lock();
+
+            if (complete) {
+               slot.state = SLOT_READ;
+               batch.read++;
+            }
+            else {
+               printf("Error test case %d is incomplete\n", batch.read+1);
+               batch.finished = TRUE;
+            }
+         }
+         batch.work_ready.notify_all();
+      }
+
+      /* write the oldest test case as soon as it is solved */
+
+      if (batch.written < batch.read) {
+         slot_type &slot = batch.slots[batch.written % batch.slots.size()];
+         while (slot.state == SLOT_READ)
+            batch.work_done.wait(guard);
+
+         guard.unlock();
+         if (slot.state == SLOT_SOLVED)
+            write(fp_out, batch.written+1, slot.instance, slot.tour);
+         guard.lock();
+         batch.written++;
+      }
+   }
+
+   guard.unlock();
+   for (i = 0; i < (int) workers.size(); i++)
+      workers[i].join();
+
+   return batch.written;
+}
@@ -0,0 +1,151 @@
+/*
+
+  travellingSalesmanGenerator.cpp - generates test cases for the travelling saleman problem in the format of input.txt,
+  so that the solvers can be compared on the same instances
+
+  Usage: travellingSalesmanGenerator kind shops test_cases seed output_file
+
+  kind is one of
+     random    every distance is drawn independently from 1 .. 1000, so the matrix has no structure at all
+     hills     the shops are points on a hilly plane: the distance is the straight line plus a penalty for
+               walking uphill, so going from i to j is longer than going back when j is higher
+     clusters  the shops are grouped on a few floors of the mall: walking within a floor is cheap, changing
+               floors costs a lot more going up (stairs) than down (escalators)
+
+  The same seed always gives the same test cases.
+
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+typedef std::vector<std::vector<int> > matrix_type;
+
+/* a shop (or the car) somewhere in the mall */
+
+struct place_type {
+   double x, y, height;
+   int floor;
+};
+
+
+matrix_type random_distances(int stops, std::mt19937 &generator) {
+   int i, j;
+   std::uniform_int_distribution<int> distance(1, 1000);
+   matrix_type d(stops, std::vector<int>(stops, 0));
+
+   for (i = 0; i < stops; i++)
+      for (j = 0; j < stops; j++)
+         if (i != j)
+            d[i][j] = distance(generator);
+   return d;
+}
+
+
+matrix_type hill_distances(int stops, std::mt19937 &generator) {
+   int i, j;
+   std::uniform_real_distribution<double> coordinate(0, 1000);
+   std::uniform_real_distribution<double> height(0, 100);
+   std::vector<place_type> places(stops);
+
+   for (i = 0; i < stops; i++) {
+      places[i].x = coordinate(generator);
+      places[i].y = coordinate(generator);
+      places[i].height = height(generator);
+   }
+
+   matrix_type d(stops, std::vector<int>(stops, 0));
+   for (i = 0; i < stops; i++)
+      for (j = 0; j < stops; j++)
+         if (i != j) {
+            double flat = hypot(places[i].x - places[j].x, places[i].y - places[j].y);
+            double climb = places[j].height - places[i].height;
+            d[i][j] = (int) (flat + (climb > 0 ? 3*climb : 0)) + 1;
+         }
+   return d;
+}
+
+
+matrix_type cluster_distances(int stops, std::mt19937 &generator) {
+   int i, j;
+   int floors = stops < 8 ? 2 : stops/4;
+   std::uniform_int_distribution<int> floor(0, floors-1);
+   std::uniform_real_distribution<double> coordinate(0, 100);
+   std::vector<place_type> places(stops);
+
+   for (i = 0; i < stops; i++) {
+      places[i].x = coordinate(generator);
+      places[i].y = coordinate(generator);
+      places[i].floor = floor(generator);
+   }
+
+   matrix_type d(stops, std::vector<int>(stops, 0));
+   for (i = 0; i < stops; i++)
+      for (j = 0; j < stops; j++)
+         if (i != j) {
+            int change = places[j].floor - places[i].floor;
+            double walk = hypot(places[i].x - places[j].x, places[i].y - places[j].y);
+            d[i][j] = (int) walk + (change > 0 ? 200*change : -50*change) + 1;
+         }
+   return d;
+}
+
+
+int main(int argc, char *argv[]) {
+   int i, j, k;
+   const char *kind;
+   int shops;
+   int number_of_test_cases;
+   unsigned seed;
+   FILE *fp_out;
+
+   if (argc != 6) {
+      fprintf(stderr, "Usage: %s random|hills|clusters shops test_cases seed output_file\n", argv[0]);
+      return 1;
+   }
+   kind = argv[1];
+   shops = atoi(argv[2]);
+   number_of_test_cases = atoi(argv[3]);
+   seed = (unsigned) strtoul(argv[4], 0, 10);
+
+   if (strcmp(kind, "random") != 0 && strcmp(kind, "hills") != 0 && strcmp(kind, "clusters") != 0) {
+      fprintf(stderr, "Error: unknown kind %s\n", kind);
+      return 1;
+   }
+
+   if ((fp_out = fopen(argv[5], "w")) == 0) {
+      fprintf(stderr, "Error: output file could not be opened\n");
+      return 1;
+   }
+
+   std::mt19937 generator(seed);
+
+   fprintf(fp_out, "%d\n", number_of_test_cases);
+   for (k = 0; k < number_of_test_cases; k++) {
+      matrix_type d;
+      if (strcmp(kind, "random") == 0)
+         d = random_distances(shops+1, generator);
+      else if (strcmp(kind, "hills") == 0)
+         d = hill_distances(shops+1, generator);
+      else
+         d = cluster_distances(shops+1, generator);
+
+      fprintf(fp_out, "%d\n", shops);
+      for (i = 0; i < shops; i++)
+         fprintf(fp_out, "Shop %d\n", i+1);
+      fprintf(fp_out, "Car\n");
+      for (i = 0; i <= shops; i++) {
+         for (j = 0; j <= shops; j++)
+            fprintf(fp_out, "%d ", d[i][j]);
+         fprintf(fp_out, "\n");
+      }
+   }
+
+   fclose(fp_out);
+   return 0;
+}
@@ -0,0 +1,214 @@
+/*
+
+  travellingSalesmanHeldKarp.cpp - dynamic programming (Held-Karp) solution of the travelling saleman problem,
+  for asymmetric instances that are too large for backtracking
+
+  See travellingSalesman.h for details of the problem
+
+  cost(R, j) is the length of the shortest route that starts at shop j, visits every shop of the set R (which
+  does not hold j) and ends at the car. The table holds it for the 2^(n-1) sets R of the other n-1 shops and
+  every j, with R squeezed into n-1 bits by taking bit j out, and the shop that follows j on that route packed
+  in 5 bits beside it.
+
+*/
+
+#include "travellingSalesman.h"
+
+#define PARENT_BITS 5                  // enough for the MAX_HELD_KARP_SHOPS shops
+#define PARENTS_PER_WORD 12            // 5-bit parents in a 64-bit word; none of them crosses two words
+#define LAYER_CHUNK 4096               // sets of a layer that one thread takes at a time
+
+
+/* the 2^(n-1) sets of the shops other than j: bit j is taken out of the set */
+
+static inline uint32_t squeeze(uint32_t set, int j) {
+   return (set & (((uint32_t) 1 << j) - 1)) | ((set >> (j+1)) << j);
+}
+
+
+/* the next larger set with as many shops (Gosper's hack) */
+
+static inline uint32_t next_set(uint32_t set) {
+   uint32_t lowest = set & (0 - set);
+   uint32_t ripple = set + lowest;
+   return ripple | (((set ^ ripple) >> 2) / lowest);
+}
+
+
+/* the set of k shops with the given rank among them in increasing order (combinatorial number system) */
+
+static uint32_t unrank_set(uint64_t rank, int k, const uint64_t binomial[][MAX_HELD_KARP_SHOPS+1]) {
+   uint32_t set = 0;
+   int c = MAX_HELD_KARP_SHOPS;
+
+   for (; k > 0; k--) {
+      while (binomial[c][k] > rank)
+         c--;
+      set |= (uint32_t) 1 << c;
+      rank -= binomial[c][k];
+   }
+   return set;
+}
+
+
+bool held_karp_solver::solve(const instance_type &instance, tour_type &tour) {
+   int i, j;
+   int n = instance.car();
+   long long longest = 0;
+   long long bound = 0;
+
+   start_statistics(&tour.statistics);
+
+   /* an upper bound on the length of any route decides how many bits the lengths need */
+
+   for (i = 0; i < instance.stops; i++) {
+      longest = 0;
+      for (j = 0; j < instance.stops; j++) {
+         if (instance.distance(i, j) < 0)
+            return fallback.solve(instance, tour);
+         if (instance.distance(i, j) > longest)
+            longest = instance.distance(i, j);
+      }
+      bound += longest;
+   }
+
+   if (n == 0 || n > MAX_HELD_KARP_SHOPS)
+      return fallback.solve(instance, tour);
+
+   /* each entry holds a length and 5 bits of the next shop */
+
+   double entries = (double) ((uint64_t) 1 << (n-1)) * n;
+   int bytes = bound < 0x7FFF ? 2 : bound < 0x7FFFFFFF ? 4 : 8;
+   double needed = entries * bytes + entries / PARENTS_PER_WORD * sizeof(uint64_t);
+   if (needed > (double) memory) {
+      fprintf(stderr, "Note: %d shops need %.0f megabytes for the Held-Karp table, more than -held-karp-memory %.0f; "
+              "solving with the table solver instead\n", n, needed / (1 << 20), (double) memory / (1 << 20));
+      return fallback.solve(instance, tour);
+   }
+
+   if (bytes == 2)
+      search(instance, tour, costs16);
+   else if (bytes == 4)
+      search(instance, tour, costs32);
+   else
+      search(instance, tour, costs64);
+   return TRUE;
+}
+
+
+/* the lengths are unsigned and a shop that is not in the set is "infinite", half of the largest value the type */
+/* holds, so that infinite plus any distance still compares greater than every real length without overflowing */
+
+template <typename cost_t> void held_karp_solver::search(const instance_type &instance, tour_type &tour, std::vector<cost_t> &costs) {
+   int j, k;
+   int n = instance.car();
+   int car = instance.car();
+   uint64_t rests = (uint64_t) 1 << (n-1);
+   uint32_t shops = ((uint32_t) 1 << n) - 1;
+   const cost_t infinite = (cost_t) (((cost_t) -1) >> 1);
+   uint64_t binomial[MAX_HELD_KARP_SHOPS+1][MAX_HELD_KARP_SHOPS+1];
+   std::vector<cost_t> distances((size_t) n*n);
+
+   for (j = 0; j < n; j++)
+      for (k = 0; k < n; k++)
+         distances[(size_t) j*n+k] = (cost_t) instance.distance(j, k);
+
+   for (j = 0; j <= MAX_HELD_KARP_SHOPS; j++)
+      for (k = 0; k <= MAX_HELD_KARP_SHOPS; k++)
+         binomial[j][k] = k == 0 ? 1 : j == 0 ? 0 : binomial[j-1][k-1] + binomial[j-1][k];
+
+   costs.resize((size_t) (rests*n));
+   next.assign((size_t) ((rests*n + PARENTS_PER_WORD-1) / PARENTS_PER_WORD), 0);
+   cost_t *cost = &costs[0];
+   uint64_t *follow = &next[0];
+   const cost_t *distance = &distances[0];
+
+   /* layer k holds the sets R of k shops; every set of layer k only needs sets of layer k-1, so the sets of a */
+   /* layer are shared out between the threads in chunks, each of which starts at the set of its rank         */
+
+   for (k = 0; k < n; k++) {
+      long long chunks = (long long) ((binomial[n][k] + LAYER_CHUNK-1) / LAYER_CHUNK);
+      long long c;
+
+      #pragma omp parallel for schedule(dynamic, 1)
+      for (c = 0; c < chunks; c++) {
+         uint64_t first = (uint64_t) c * LAYER_CHUNK;
+         uint64_t last = first + LAYER_CHUNK < binomial[n][k] ? first + LAYER_CHUNK : binomial[n][k];
+         uint32_t set = unrank_set(first, k, binomial);
+
+         for (uint64_t r = first; r < last; r++, set = k == 0 ? set : next_set(set)) {
+            cost_t rest[MAX_HELD_KARP_SHOPS];
+
+            /* cost(R\{i}, i) for every i of the set, which is the same whatever shop comes before i; the */
+            /* shops that are not in the set are infinite                                                 */
+
+            for (int i = 0; i < n; i++)
+               rest[i] = (set & ((uint32_t) 1 << i)) ? cost[(size_t) squeeze(set & ~((uint32_t) 1 << i), i) * n + i] : infinite;
+
+            for (int shop = 0; shop < n; shop++) {
+               if (set & ((uint32_t) 1 << shop))
+                  continue;
+
+               size_t entry = (size_t) squeeze(set, shop) * n + shop;
+               const cost_t *from = distance + (size_t) shop*n;
+               cost_t best = (cost_t) instance.distance(shop, car);
+               int following = car;
+
+               if (set != 0) {
+                  best = (cost_t) -1;
+
+                  #pragma omp simd reduction(min:best)
+                  for (int i = 0; i < n; i++) {
+                     cost_t length = (cost_t) (rest[i] + from[i]);
+                     best = length < best ? length : best;
+                  }
+
+                  /* of equally short routes take the one through the shop with the largest number, as backtracking does */
+
+                  following = n-1;
+                  while ((cost_t) (rest[following] + from[following]) != best)
+                     following--;
+               }
+               cost[entry] = best;
+
+               /* the entries of a word belong to sets that other threads may have */
+
+               uint64_t bits = (uint64_t) following << (PARENT_BITS * (entry % PARENTS_PER_WORD));
+               uint64_t *word = follow + entry / PARENTS_PER_WORD;
+               #pragma omp atomic
+               *word |= bits;
+            }
+         }
+      }
+   }
+
+   /* the first shop after the car, then follow the parents */
+
+   uint32_t set = shops;
+   int shop = n-1;
+   long long length;
+
+   tour.cost = LLONG_MAX;
+   for (j = n-1; j >= 0; j--) {
+      length = (long long) instance.distance(car, j) + cost[(size_t) squeeze(set & ~((uint32_t) 1 << j), j) * n + j];
+      if (length < tour.cost) {
+         tour.cost = length;
+         shop = j;
+      }
+   }
+
+   tour.stops.clear();
+   tour.stops.push_back(car);
+   while (shop != car) {
+      tour.stops.push_back(shop);
+      set &= ~((uint32_t) 1 << shop);
+      size_t entry = (size_t) squeeze(set, shop) * n + shop;
+      shop = (int) ((follow[entry / PARENTS_PER_WORD] >> (PARENT_BITS * (entry % PARENTS_PER_WORD))) & ((1 << PARENT_BITS) - 1));
+   }
+   tour.stops.push_back(car);
+   tour.lower_bound = tour.cost;
+
+   tour.statistics.nodes = (long long) (rests*n);
+   count_incumbent(&tour.statistics);
+   stop_statistics(&tour.statistics);
+}
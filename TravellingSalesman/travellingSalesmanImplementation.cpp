@@ -23,3 +23,426 @@ void remove_new_line(char string[]) {
 }
 
 
+
+
+/* streaming parser */
+/* ---------------- */
+
+/* refill the buffer; returns FALSE if there is nothing more to read */
+
+static bool fill_buffer(reader_type *reader) {
+   reader->length = (int) fread(reader->buffer, 1, READER_BUFFER_SIZE, reader->fp);
+   reader->position = 0;
+   return reader->length > 0;
+}
+
+/* the next character without consuming it, or EOF */
+
+static int peek_char(reader_type *reader) {
+   if (reader->position == reader->length && !fill_buffer(reader))
+      return EOF;
+   return (unsigned char) reader->buffer[reader->position];
+}
+
+bool open_reader(reader_type *reader, const char *filename) {
+   if ((reader->fp = fopen(filename, "rb")) == 0)
+      return FALSE;
+   reader->position = 0;
+   reader->length = 0;
+   reader->test_cases = 0;
+   return TRUE;
+}
+
+void close_reader(reader_type *reader) {
+   fclose(reader->fp);
+}
+
+bool read_integer(reader_type *reader, int *value) {
+   int c;
+   int sign = 1;
+   int result = 0;
+
+   while ((c = peek_char(reader)) == ' ' || c == '\t' || c == '\r' || c == '\n')
+      reader->position++;
+
+   if (c == '-') {
+      sign = -1;
+      reader->position++;
+      c = peek_char(reader);
+   }
+   if (c < '0' || c > '9')
+      return FALSE;
+
+   while (c >= '0' && c <= '9') {
+      result = result*10 + (c - '0');
+      reader->position++;
+      c = peek_char(reader);
+   }
+   *value = sign*result;
+   return TRUE;
+}
+
+bool read_line(reader_type *reader, std::string &line) {
+   line.clear();
+   if (peek_char(reader) == EOF)
+      return FALSE;
+
+   while (TRUE) {
+      char *start = reader->buffer + reader->position;
+      char *end = (char *) memchr(start, '\n', reader->length - reader->position);
+
+      if (end != 0) {
+         line.append(start, end - start);
+         reader->position += (int) (end - start) + 1;
+         break;
+      }
+      line.append(start, reader->length - reader->position);
+      reader->position = reader->length;
+      if (peek_char(reader) == EOF)
+         break;
+   }
+
+   if (!line.empty() && line[line.size()-1] == '\r')
+      line.resize(line.size()-1);
+   return TRUE;
+}
+
+bool read_test_case(reader_type *reader, instance_type *instance) {
+   int i;
+   int n;
+   std::string rest;
+
+   /* number of shops; the names begin on the next line */
+
+   if (!read_integer(reader, &n) || n < 0)
+      return FALSE;
+   read_line(reader, rest);
+
+   instance->number = ++reader->test_cases;
+   instance->stops = n+1;
+   instance->names.resize(n+1);
+   instance->distances.resize((size_t) (n+1)*(n+1));
+
+   /* the shop names and the car name */
+
+   for (i = 0; i < n+1; i++) {
+      if (!read_line(reader, instance->names[i]))
+         return FALSE;
+   }
+
+   /* the matrix of distances; the numbers may be spread over the lines in any way */
+
+   for (i = 0; i < (n+1)*(n+1); i++) {
+      if (!read_integer(reader, &(instance->distances[i])))
+         return FALSE;
+   }
+   return TRUE;
+}
+
+
+/* backtracking */
+/* ------------ */
+
+bool backtracking_solver::solve(const instance_type &instance, tour_type &tour) {
+   this->instance = &instance;
+   best = &tour;
+
+   best->cost = LLONG_MAX;
+   best->stops.clear();
+   start_statistics(&best->statistics);
+   visited.assign(instance.stops, FALSE);
+   route.resize(instance.stops+1);
+   route[0] = instance.car();
+
+   extend(0, instance.car(), 0);
+
+   stop_statistics(&best->statistics);
+   best->lower_bound = best->cost;
+   return !best->stops.empty();
+}
+
+/* add one more shop to the partial route of depth shops ending at last, or go back to the car if all shops have been visited */
+/* the branch is cut as soon as the partial route is not shorter than the best tour found so far */
+
+void backtracking_solver::extend(int depth, int last, long long cost) {
+   int i;
+   int car = instance->car();
+
+   if (cost >= best->cost) {
+      best->statistics.bound_prunes++;
+      return;
+   }
+   best->statistics.nodes++;
+
+   if (depth == car) {
+      cost += instance->distance(last, car);
+      if (cost < best->cost) {
+         route[depth+1] = car;
+         best->cost = cost;
+         best->stops.assign(route.begin(), route.begin()+depth+2);
+         count_incumbent(&best->statistics);
+      }
+      return;
+   }
+
+   for (i = car-1; i >= 0; i--) {
+      if (!visited[i]) {
+         visited[i] = TRUE;
+         route[depth+1] = i;
+         extend(depth+1, i, cost + instance->distance(last, i));
+         visited[i] = FALSE;
+      }
+   }
+}
+
+
+/* backtracking with a transposition table */
+/* ---------------------------------------- */
+
+void transposition_table::reset(int shops, size_t memory) {
+   size_t states;
+   size_t count = 1;
+   size_t limit = memory / sizeof(table_bucket_type);
+
+   /* there are at most 2^shops * shops states, so a small test case only clears a small table */
+
+   states = shops < 40 ? ((size_t) 1 << shops) * shops : (size_t) -1;
+   while (count < limit && count*TABLE_WAYS < states && count*2 <= limit)
+      count *= 2;
+
+   if (buckets.size() < count)
+      buckets.resize(count);
+   mask = count-1;
+
+   for (size_t i = 0; i < count; i++) {
+      memset(buckets[i].last, -1, sizeof(buckets[i].last));
+      buckets[i].referenced = 0;
+      buckets[i].hand = 0;
+   }
+}
+
+bool transposition_table::dominated(uint64_t visited, int last, long long cost) {
+   int i;
+   uint64_t hash = (visited ^ ((uint64_t) last << 58)) * 0x9E3779B97F4A7C15ULL;
+   table_bucket_type &bucket = buckets[(size_t) (hash >> 32) & mask];
+
+   for (i = 0; i < TABLE_WAYS; i++) {
+      if (bucket.last[i] == last && bucket.visited[i] == visited) {
+         bucket.referenced |= 1 << i;
+         if (bucket.cost[i] <= cost)
+            return TRUE;
+         bucket.cost[i] = cost;
+         return FALSE;
+      }
+   }
+
+   /* not in the table: take an empty entry or the first one the clock finds unreferenced */
+
+   for (i = 0; i < TABLE_WAYS && bucket.last[i] != -1; i++)
+      ;
+   if (i == TABLE_WAYS) {
+      while (bucket.referenced & (1 << bucket.hand)) {
+         bucket.referenced &= ~(1 << bucket.hand);
+         bucket.hand = (bucket.hand + 1) % TABLE_WAYS;
+      }
+      i = bucket.hand;
+      bucket.hand = (bucket.hand + 1) % TABLE_WAYS;
+   }
+
+   bucket.visited[i] = visited;
+   bucket.last[i] = (int16_t) last;
+   bucket.cost[i] = cost;
+   bucket.referenced |= 1 << i;
+   return FALSE;
+}
+
+bool table_solver::solve(const instance_type &instance, tour_type &tour) {
+   this->instance = &instance;
+   best = &tour;
+
+   best->cost = LLONG_MAX;
+   best->stops.clear();
+   start_statistics(&best->statistics);
+   route.resize(instance.stops+1);
+   route[0] = instance.car();
+
+   /* with more shops than bits in the mask the table can't be used and this is plain backtracking */
+
+   if (instance.car() <= MAX_TABLE_SHOPS) {
+      table.reset(instance.car(), memory);
+      extend(0, instance.car(), 0, 0);
+      stop_statistics(&best->statistics);
+      best->lower_bound = best->cost;
+      return !best->stops.empty();
+   }
+
+   backtracking_solver plain;
+   return plain.solve(instance, tour);
+}
+
+/* the same search as backtracking_solver::extend; a partial route is dropped if another one that visited the same  */
+/* shops and ends at the same shop was at least as short: its continuations were all tried before with a bound that */
+/* was no better, so dropping this one can't change the tour selected                                               */
+
+void table_solver::extend(int depth, int last, uint64_t visited, long long cost) {
+   int i;
+   int car = instance->car();
+
+   if (cost >= best->cost) {
+      best->statistics.bound_prunes++;
+      return;
+   }
+
+   if (depth > 0 && table.dominated(visited, last, cost)) {
+      best->statistics.table_prunes++;
+      return;
+   }
+   best->statistics.nodes++;
+
+   if (depth == car) {
+      cost += instance->distance(last, car);
+      if (cost < best->cost) {
+         route[depth+1] = car;
+         best->cost = cost;
+         best->stops.assign(route.begin(), route.begin()+depth+2);
+         count_incumbent(&best->statistics);
+      }
+      return;
+   }
+
+   for (i = car-1; i >= 0; i--) {
+      if (!(visited & ((uint64_t) 1 << i))) {
+         route[depth+1] = i;
+         extend(depth+1, i, visited | ((uint64_t) 1 << i), cost + instance->distance(last, i));
+      }
+   }
+}
+
+
+/* solvers and output */
+/* ------------------ */
+
+solver_type *create_solver(const options_type &options) {
+   if (strcmp(options.solver, "backtrack") == 0)
+      return new backtracking_solver();
+   if (strcmp(options.solver, "table") == 0)
+      return new table_solver(options.table_memory);
+   if (strcmp(options.solver, "heldkarp") == 0)
+      return new held_karp_solver(options.held_karp_memory, options.table_memory);
+   if (strcmp(options.solver, "anytime") == 0)
+      return new anytime_solver(options.deadline, options.table_memory, options.report);
+   return 0;
+}
+
+void write_tour(FILE *fp_out, int test_case, const instance_type &instance, const tour_type &tour) {
+   int i;
+
+   fprintf(fp_out, "%d\n", test_case);
+   fprintf(fp_out, "%lld\n", tour.cost);
+   for (i = 0; i < (int) tour.stops.size(); i++)
+      fprintf(fp_out, "%s\n", instance.names[tour.stops[i]].c_str());
+   if (tour.lower_bound < tour.cost)
+      fprintf(fp_out, "lower bound %lld, gap %.2f%%\n", tour.lower_bound,
+              tour.cost > 0 ? 100.0*(tour.cost - tour.lower_bound)/tour.cost : 0.0);
+}
+
+void start_statistics(statistics_type *statistics) {
+   statistics->nodes = 0;
+   statistics->bound_prunes = 0;
+   statistics->table_prunes = 0;
+   statistics->deadline_prunes = 0;
+   statistics->incumbents = 0;
+   statistics->first_time = statistics->best_time = statistics->total_time = 0;
+   statistics->start = std::chrono::steady_clock::now();
+}
+
+static double elapsed(const statistics_type *statistics) {
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - statistics->start).count();
+}
+
+void count_incumbent(statistics_type *statistics) {
+   statistics->best_time = elapsed(statistics);
+   if (statistics->incumbents++ == 0)
+      statistics->first_time = statistics->best_time;
+}
+
+void stop_statistics(statistics_type *statistics) {
+   statistics->total_time = elapsed(statistics);
+}
+
+void write_statistics(FILE *fp, int test_case, const instance_type &instance, const tour_type &tour) {
+   const statistics_type &statistics = tour.statistics;
+
+   if (test_case == 0) {
+      fprintf(fp, "test_case,shops,cost,lower_bound,nodes,bound_prunes,table_prunes,deadline_prunes,incumbents,first_ms,best_ms,total_ms\n");
+      return;
+   }
+   fprintf(fp, "%d,%d,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%.3f,%.3f,%.3f\n", test_case, instance.stops-1, tour.cost, tour.lower_bound,
+           statistics.nodes, statistics.bound_prunes, statistics.table_prunes, statistics.deadline_prunes, statistics.incumbents,
+           statistics.first_time, statistics.best_time, statistics.total_time);
+}
+
+/* the threads of a batch report at the same time, so the line is put together first and written with one fputs, */
+/* which stdio does not interleave with the lines of the other threads                                          */
+
+void print_incumbent(const instance_type &instance, const tour_type &tour) {
+   int i;
+   char number[64];
+   std::string line;
+
+   sprintf(number, "test case %d: %lld", instance.number, tour.cost);
+   line = number;
+   for (i = 0; i < (int) tour.stops.size(); i++) {
+      line += i == 0 ? " " : " > ";
+      line += instance.names[tour.stops[i]];
+   }
+   line += "\n";
+   fputs(line.c_str(), stdout);
+}
+
+
+/* options */
+/* ------- */
+
+bool parse_options(int argc, char *argv[], options_type *options) {
+   int i;
+
+   options->solver = "backtrack";
+   options->threads = 1;
+   options->window = 0;
+   options->table_memory = (size_t) 64 << 20;
+   options->held_karp_memory = (size_t) 2048 << 20;
+   options->deadline = 1000;
+   options->report = 0;
+   options->statistics = 0;
+   options->debug = FALSE;
+
+   for (i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "-threads") == 0 && i+1 < argc)
+         options->threads = atoi(argv[++i]);
+      else if (strcmp(argv[i], "-window") == 0 && i+1 < argc)
+         options->window = atoi(argv[++i]);
+      else if (strcmp(argv[i], "-table-memory") == 0 && i+1 < argc)
+         options->table_memory = (size_t) atoi(argv[++i]) << 20;
+      else if (strcmp(argv[i], "-held-karp-memory") == 0 && i+1 < argc)
+         options->held_karp_memory = (size_t) atoi(argv[++i]) << 20;
+      else if (strcmp(argv[i], "-deadline") == 0 && i+1 < argc)
+         options->deadline = atol(argv[++i]);
+      else if (strcmp(argv[i], "-progress") == 0)
+         options->report = print_incumbent;
+      else if (strcmp(argv[i], "-statistics") == 0 && i+1 < argc)
+         options->statistics = argv[++i];
+      else if (strcmp(argv[i], "-debug") == 0)
+         options->debug = TRUE;
+      else if (argv[i][0] != '-')
+         options->solver = argv[i];
+      else
+         return FALSE;
+   }
+
+   if (options->threads < 1)
+      return FALSE;
+   if (options->window < options->threads)
+      options->window = 4*options->threads;
+   return TRUE;
+}